@@ -0,0 +1,29 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_ALLOCATIONS
+#define ARTICLES_ALLOCATIONS
+
+#include "graphs.hpp"
+
+namespace allocations {
+
+// Tracking of the heap allocations done through the global operator new
+// and delete (replaced in allocations.cpp). When enabled, every allocation
+// between start() and stop() is counted and timed, on any thread. This
+// slows the allocations down, so it is disabled by default and the
+// benchmarks track them in a pass that is not timed.
+
+void enable(bool enabled);
+bool enabled();
+
+void start();
+graphs::allocations stop();
+
+} //end of namespace allocations
+
+#endif
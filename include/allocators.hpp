@@ -0,0 +1,240 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_ALLOCATORS
+#define ARTICLES_ALLOCATORS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+// Allocators to compare the node based containers without the cost of
+// one new/delete per node. The memory is owned by a resource shared by
+// all the copies (and rebinds) of the allocator: each default constructed
+// allocator, so each container, gets its own resource, released when the
+// last copy is destroyed.
+
+namespace allocators {
+
+// Bump allocator: memory is taken from large chunks and only given back
+// when the arena is destroyed
+
+class arena {
+    public:
+        static const std::size_t first_chunk = 64 * 1024;
+        static const std::size_t max_chunk = 64 * 1024 * 1024;
+
+        arena() = default;
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena(){
+            for(auto chunk : chunks){
+                ::operator delete(chunk);
+            }
+        }
+
+        void* allocate(std::size_t bytes, std::size_t alignment){
+            auto address = (current + alignment - 1) & ~(alignment - 1);
+
+            if(!current || address + bytes > end){
+                grow(bytes + alignment);
+                address = (current + alignment - 1) & ~(alignment - 1);
+            }
+
+            current = address + bytes;
+
+            return reinterpret_cast<void*>(address);
+        }
+
+        void deallocate(void*, std::size_t){
+            //Nothing, released with the arena
+        }
+
+    private:
+        std::vector<void*> chunks;
+        std::uintptr_t current = 0;
+        std::uintptr_t end = 0;
+        std::size_t next_chunk = first_chunk;
+
+        void grow(std::size_t bytes){
+            auto size = std::max(next_chunk, bytes);
+            next_chunk = next_chunk < max_chunk / 2 ? next_chunk * 2 : max_chunk;
+
+            chunks.reserve(chunks.size() + 1);
+            auto chunk = ::operator new(size);
+            chunks.push_back(chunk);
+
+            current = reinterpret_cast<std::uintptr_t>(chunk);
+            end = current + size;
+        }
+};
+
+// Fixed size blocks recycled through a free list. The block size is set by
+// the first single object allocation (the nodes of a node based
+// container), arrays and other sizes are forwarded to operator new. The
+// number of objects is passed along the size for that: an array of one
+// block size (a deque map for instance) must not fix the block size.
+
+class pool {
+    public:
+        static const std::size_t blocks_per_chunk = 1024;
+
+        pool() = default;
+
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+
+        ~pool(){
+            for(auto chunk : chunks){
+                ::operator delete(chunk);
+            }
+        }
+
+        void* allocate(std::size_t bytes, std::size_t objects){
+            if(!block_size && objects == 1){
+                block_size = std::max(round_up(bytes), sizeof(free_block));
+            }
+
+            if(!pooled(bytes, objects)){
+                return ::operator new(bytes);
+            }
+
+            if(!free_list){
+                grow();
+            }
+
+            auto block = free_list;
+            free_list = free_list->next;
+            return block;
+        }
+
+        void deallocate(void* p, std::size_t bytes, std::size_t objects){
+            if(!pooled(bytes, objects)){
+                ::operator delete(p);
+                return;
+            }
+
+            auto block = static_cast<free_block*>(p);
+            block->next = free_list;
+            free_list = block;
+        }
+
+    private:
+        struct free_block {
+            free_block* next;
+        };
+
+        std::vector<void*> chunks;
+        free_block* free_list = nullptr;
+        std::size_t block_size = 0;
+
+        static std::size_t round_up(std::size_t bytes){
+            const std::size_t alignment = alignof(std::max_align_t);
+            return (bytes + alignment - 1) & ~(alignment - 1);
+        }
+
+        bool pooled(std::size_t bytes, std::size_t objects) const {
+            return objects == 1 && std::max(round_up(bytes), sizeof(free_block)) == block_size;
+        }
+
+        void grow(){
+            chunks.reserve(chunks.size() + 1);
+            auto chunk = static_cast<char*>(::operator new(block_size * blocks_per_chunk));
+            chunks.push_back(chunk);
+
+            for(std::size_t i = blocks_per_chunk; i > 0; --i){
+                auto block = reinterpret_cast<free_block*>(chunk + (i - 1) * block_size);
+                block->next = free_list;
+                free_list = block;
+            }
+        }
+};
+
+template<typename T>
+struct arena_allocator {
+    typedef T value_type;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    std::shared_ptr<allocators::arena> resource;
+
+    arena_allocator() : resource(std::make_shared<allocators::arena>()) {}
+
+    // no move constructor, a moved from container must still be able to
+    // release what it allocates (libstdc++ deque allocates a new map in it)
+    arena_allocator(const arena_allocator&) = default;
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U>& rhs) : resource(rhs.resource) {}
+
+    T* allocate(std::size_t n){
+        return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n){
+        resource->deallocate(p, n * sizeof(T));
+    }
+};
+
+template<typename T>
+struct pool_allocator {
+    typedef T value_type;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    std::shared_ptr<allocators::pool> resource;
+
+    pool_allocator() : resource(std::make_shared<allocators::pool>()) {}
+
+    // no move constructor, a moved from container must still be able to
+    // release what it allocates (libstdc++ deque allocates a new map in it)
+    pool_allocator(const pool_allocator&) = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>& rhs) : resource(rhs.resource) {}
+
+    T* allocate(std::size_t n){
+        return static_cast<T*>(resource->allocate(n * sizeof(T), n));
+    }
+
+    void deallocate(T* p, std::size_t n){
+        resource->deallocate(p, n * sizeof(T), n);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs){
+    return lhs.resource == rhs.resource;
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs){
+    return lhs.resource != rhs.resource;
+}
+
+template<typename T, typename U>
+bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs){
+    return lhs.resource == rhs.resource;
+}
+
+template<typename T, typename U>
+bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs){
+    return lhs.resource != rhs.resource;
+}
+
+} //end of namespace allocators
+
+#endif
@@ -6,8 +6,16 @@
 //=======================================================================
 
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <regex>
+#include <iostream>
 
 #include "graphs.hpp"
+#include "perf.hpp"
+#include "isolation.hpp"
+#include "allocations.hpp"
 #include "demangle.hpp"
 
 // chrono typedefs
@@ -17,9 +25,120 @@ using std::chrono::microseconds;
 
 using Clock = std::chrono::high_resolution_clock;
 
-// Number of repetitions of each test
+// Number of repetitions of each test: after the warm-up, a test is
+// repeated until the relative standard error of its mean drops below
+// TARGET_RSE, between MIN_REPEAT and MAX_REPEAT times, or until it
+// has run for MAX_TIME
 
-static const std::size_t REPEAT = 7;
+static const std::size_t WARMUP = 1;
+static const std::size_t MIN_REPEAT = 7;
+static const std::size_t MAX_REPEAT = 100;
+static const double TARGET_RSE = 0.01;
+static const std::chrono::seconds MAX_TIME(10);
+
+// statistics of the samples (in nanoseconds)
+
+graphs::statistics compute_statistics(std::vector<double> samples){
+    graphs::statistics stats = {};
+
+    if(samples.empty()){
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    const std::size_t n = samples.size();
+
+    stats.iterations = n;
+    stats.min = samples.front();
+    stats.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    stats.p90 = samples[static_cast<std::size_t>(std::ceil(0.9 * n)) - 1];
+
+    double sum = 0.0;
+    for(auto sample : samples){
+        sum += sample;
+    }
+
+    stats.mean = sum / n;
+
+    double squares = 0.0;
+    for(auto sample : samples){
+        squares += (sample - stats.mean) * (sample - stats.mean);
+    }
+
+    stats.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+
+    return stats;
+}
+
+bool precise_enough(const std::vector<double>& samples){
+    if(samples.size() < MIN_REPEAT){
+        return false;
+    }
+
+    auto stats = compute_statistics(samples);
+    return stats.mean == 0.0 || stats.stddev / std::sqrt(static_cast<double>(samples.size())) / stats.mean <= TARGET_RSE;
+}
+
+// hardware counters around each test, when available
+
+perf::counter_group& hardware_counters(){
+    static perf::counter_group group;
+    return group;
+}
+
+// a counter missing in one of the iterations is not available for the result
+
+void add_counter(double& total, double sample){
+    total = (total < 0.0 || sample < 0.0) ? -1.0 : total + sample;
+}
+
+void add_counters(graphs::counters& total, const graphs::counters& sample){
+    add_counter(total.cycles, sample.cycles);
+    add_counter(total.instructions, sample.instructions);
+    add_counter(total.cache_misses, sample.cache_misses);
+    add_counter(total.branch_misses, sample.branch_misses);
+    add_counter(total.dtlb_misses, sample.dtlb_misses);
+}
+
+graphs::counters average_counters(graphs::counters total, std::size_t iterations){
+    for(auto field : {&graphs::counters::cycles, &graphs::counters::instructions, &graphs::counters::cache_misses,
+            &graphs::counters::branch_misses, &graphs::counters::dtlb_misses}){
+        if(total.*field >= 0.0){
+            total.*field /= iterations;
+        }
+    }
+
+    return total;
+}
+
+// selection of the benchmarks to run: a benchmark, type, serie or size
+// is run if it fully matches one of the regexes of its category, or if
+// there are none. In list mode, the selected cells are only printed.
+
+struct selection {
+    std::vector<std::regex> benchmarks;
+    std::vector<std::regex> types;
+    std::vector<std::regex> series;
+    std::vector<std::regex> sizes;
+    bool list;
+    bool graph_selected;
+};
+
+selection& selected(){
+    static selection s{{}, {}, {}, {}, false, true};
+    return s;
+}
+
+void select(std::vector<std::regex>& filters, const std::vector<std::string>& values){
+    for(auto& value : values){
+        filters.emplace_back(value);
+    }
+}
+
+bool matches(const std::vector<std::regex>& filters, const std::string& value){
+    return filters.empty() || std::any_of(filters.begin(), filters.end(), [&value](const std::regex& filter){ return std::regex_match(value, filter); });
+}
 
 // variadic policy runner
 
@@ -34,6 +153,112 @@ inline static void run(Container &container, std::size_t size){
     run<Rest...>(container, size);
 }
 
+// optional members of the test policies: a static prepare(), called once
+// in the process measuring the cell before any run (e.g. to start the
+// threads of the policy), and a static multithreaded flag, set when the
+// run uses other threads than the calling one, which the hardware
+// counters do not see
+
+template<template<class> class Test, class Container>
+inline auto prepare_policy(int) -> decltype(Test<Container>::prepare()) {
+    Test<Container>::prepare();
+}
+
+template<template<class> class Test, class Container>
+inline void prepare_policy(long){}
+
+template<class Container>
+inline static void prepare(){
+    //End of recursion
+}
+
+template<class Container, template<class> class Test, template<class> class ...Rest>
+inline static void prepare(){
+    prepare_policy<Test, Container>(0);
+    prepare<Container, Rest...>();
+}
+
+template<template<class> class Test, class Container>
+constexpr auto multithreaded_policy(int) -> decltype(bool(Test<Container>::multithreaded)) {
+    return Test<Container>::multithreaded;
+}
+
+template<template<class> class Test, class Container>
+constexpr bool multithreaded_policy(long){
+    return false;
+}
+
+template<class Container>
+constexpr bool multithreaded(){
+    return false;
+}
+
+template<class Container, template<class> class Test, template<class> class ...Rest>
+constexpr bool multithreaded(){
+    return multithreaded_policy<Test, Container>(0) || multithreaded<Container, Rest...>();
+}
+
+// heap allocations of one run, in a separate pass so that the cost of
+// tracking them does not end up in the timed samples
+
+template<typename Container,
+         template<class> class CreatePolicy,
+         template<class> class ...TestPolicy>
+graphs::allocations measure_allocations(std::size_t size){
+    if(!allocations::enabled()){
+        return graphs::unavailable_allocations();
+    }
+
+    auto container = CreatePolicy<Container>::make(size);
+
+    allocations::start();
+    run<TestPolicy...>(container, size);
+    return allocations::stop();
+}
+
+// measure of one size
+
+template<typename Container,
+         template<class> class CreatePolicy,
+         template<class> class ...TestPolicy>
+isolation::measurement measure(std::size_t size){
+    prepare<Container, TestPolicy...>();
+
+    for(std::size_t i=0; i<WARMUP; ++i) {
+        auto container = CreatePolicy<Container>::make(size);
+        run<TestPolicy...>(container, size);
+    }
+
+    std::vector<double> samples;
+    Clock::duration total(0);
+
+    auto& group = hardware_counters();
+    graphs::counters hw = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    while(samples.size() < MAX_REPEAT && (samples.size() < MIN_REPEAT || total < MAX_TIME) && !precise_enough(samples)) {
+        auto container = CreatePolicy<Container>::make(size);
+
+        group.start();
+
+        Clock::time_point t0 = Clock::now();
+
+        run<TestPolicy...>(container, size);
+
+        Clock::time_point t1 = Clock::now();
+
+        add_counters(hw, group.stop());
+
+        total += t1 - t0;
+        samples.push_back(std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(t1 - t0).count());
+    }
+
+    if(multithreaded<Container, TestPolicy...>()){
+        hw = graphs::unavailable_counters();
+    }
+
+    return {samples, average_counters(hw, samples.size()), measure_allocations<Container, CreatePolicy, TestPolicy...>(size)};
+}
+
 // benchmarking procedure
 
 template<typename Container,
@@ -41,23 +266,41 @@ template<typename Container,
          template<class> class CreatePolicy,
          template<class> class ...TestPolicy>
 void bench(const std::string& type, const std::initializer_list<int> &sizes){
-    // create an element to copy so the temporary creation
-    // and initialization will not be accounted in a benchmark
-    for(auto size : sizes) {
-        std::size_t duration = 0;
+    if(!selected().graph_selected || !matches(selected().series, type)){
+        return;
+    }
 
-        for(std::size_t i=0; i<REPEAT; ++i) {
-            auto container = CreatePolicy<Container>::make(size);
+    if(selected().list){
+        std::cout << "    " << type << ":";
 
-            Clock::time_point t0 = Clock::now();
+        for(auto size : sizes){
+            if(matches(selected().sizes, std::to_string(size))){
+                std::cout << " " << size;
+            }
+        }
 
-            run<TestPolicy...>(container, size);
+        std::cout << std::endl;
+        return;
+    }
 
-            Clock::time_point t1 = Clock::now();
-            duration += std::chrono::duration_cast<DurationUnit>(t1 - t0).count();
+    // create an element to copy so the temporary creation
+    // and initialization will not be accounted in a benchmark
+    for(auto size : sizes) {
+        if(!matches(selected().sizes, std::to_string(size))){
+            continue;
         }
 
-        graphs::new_result(type, std::to_string(size), duration / REPEAT);
+        // in a child process when isolated, so that the heap and the
+        // caches of the previous cells do not pollute this one
+        isolation::measurement m;
+        if(!isolation::run([size](){ return measure<Container, CreatePolicy, TestPolicy...>(size); }, m)){
+            continue;
+        }
+
+        auto stats = compute_statistics(m.samples);
+        auto unit = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(DurationUnit(1)).count();
+
+        graphs::new_result(type, std::to_string(size), static_cast<std::size_t>(stats.mean / unit + 0.5), stats, m.hw, m.samples, m.heap);
     }
 
     CreatePolicy<Container>::clean();
@@ -87,6 +330,19 @@ std::string tag(std::string name){
 
 template<typename T>
 void new_graph(const std::string &testName, const std::string &unit){
-    std::string title(testName + " - " + demangle(typeid(T).name()));
+    std::string type(demangle(typeid(T).name()));
+    std::string title(testName + " - " + type);
+
+    selected().graph_selected = matches(selected().benchmarks, testName) && matches(selected().types, type);
+
+    if(!selected().graph_selected){
+        return;
+    }
+
+    if(selected().list){
+        std::cout << title << std::endl;
+        return;
+    }
+
     graphs::new_graph(tag(title), title, unit);
 }
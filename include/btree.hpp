@@ -0,0 +1,346 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_BTREE
+#define ARTICLES_BTREE
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace containers {
+
+// Default number of elements per node, about four cache lines of elements
+template<typename T>
+constexpr std::size_t default_fanout(){
+    return 256 / sizeof(T) < 4 ? 4 : 256 / sizeof(T);
+}
+
+// Ordered set stored in a B+tree.
+//
+// Every node holds up to Fanout elements in a sorted array, so a lookup
+// does a few binary searches in contiguous memory instead of following
+// one pointer per comparison like a red-black tree. The elements are all
+// in the leaves, the inner nodes only hold copies of the first element of
+// their children. The leaves are linked together so that the iteration is
+// a walk over arrays. Only insertion and lookup are supported.
+
+template<typename T, std::size_t Fanout = default_fanout<T>(), typename Compare = std::less<T>>
+class btree_set {
+    static_assert(Fanout >= 3, "A node must be splittable in two non-empty nodes");
+
+    private:
+        struct node {
+            bool leaf;
+            std::size_t count;
+        };
+
+        struct leaf_node : node {
+            T values[Fanout];
+            leaf_node* next;
+        };
+
+        struct inner_node : node {
+            T keys[Fanout];             // keys[i] is the first element of children[i + 1]
+            node* children[Fanout + 1];
+        };
+
+    public:
+        typedef T value_type;
+        typedef T key_type;
+
+        class iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef const T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const T* pointer;
+                typedef const T& reference;
+
+                iterator() = default;
+
+                const T& operator*() const {
+                    return leaf->values[index];
+                }
+
+                const T* operator->() const {
+                    return &leaf->values[index];
+                }
+
+                iterator& operator++(){
+                    if(++index == leaf->count){
+                        leaf = leaf->next;
+                        index = 0;
+                    }
+
+                    return *this;
+                }
+
+                iterator operator++(int){
+                    iterator it = *this;
+                    ++*this;
+                    return it;
+                }
+
+                bool operator==(const iterator& rhs) const {
+                    return leaf == rhs.leaf && index == rhs.index;
+                }
+
+                bool operator!=(const iterator& rhs) const {
+                    return !(*this == rhs);
+                }
+
+            private:
+                const leaf_node* leaf = nullptr;
+                std::size_t index = 0;
+
+                iterator(const leaf_node* leaf, std::size_t index) : leaf(leaf), index(index) {}
+
+                friend class btree_set;
+        };
+
+        typedef iterator const_iterator;
+
+        explicit btree_set(Compare compare = Compare()) : compare(compare) {}
+
+        btree_set(const btree_set& rhs) : compare(rhs.compare) {
+            for(auto& value : rhs){
+                insert(value);
+            }
+        }
+
+        btree_set(btree_set&& rhs) noexcept : btree_set() {
+            swap(rhs);
+        }
+
+        btree_set& operator=(btree_set rhs){
+            swap(rhs);
+            return *this;
+        }
+
+        ~btree_set(){
+            destroy(root);
+        }
+
+        void swap(btree_set& rhs) noexcept {
+            std::swap(root, rhs.root);
+            std::swap(first, rhs.first);
+            std::swap(size_, rhs.size_);
+            std::swap(compare, rhs.compare);
+        }
+
+        iterator begin() const {
+            return iterator(first, 0);
+        }
+
+        iterator end() const {
+            return iterator();
+        }
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        void clear(){
+            destroy(root);
+            root = nullptr;
+            first = nullptr;
+            size_ = 0;
+        }
+
+        iterator find(const T& value) const {
+            if(!root){
+                return end();
+            }
+
+            const node* current = root;
+
+            while(!current->leaf){
+                auto inner = static_cast<const inner_node*>(current);
+                current = inner->children[std::upper_bound(inner->keys, inner->keys + inner->count, value, compare) - inner->keys];
+            }
+
+            auto leaf = static_cast<const leaf_node*>(current);
+            auto position = std::lower_bound(leaf->values, leaf->values + leaf->count, value, compare);
+
+            if(position == leaf->values + leaf->count || compare(value, *position)){
+                return end();
+            }
+
+            return iterator(leaf, position - leaf->values);
+        }
+
+        std::size_t count(const T& value) const {
+            return find(value) != end();
+        }
+
+        std::pair<iterator, bool> insert(const T& value){
+            if(!root){
+                auto leaf = new leaf_node();
+                leaf->leaf = true;
+                leaf->count = 0;
+                leaf->next = nullptr;
+                root = first = leaf;
+            }
+
+            split_result split;
+            auto inserted = insert(root, value, split);
+
+            if(split.right){
+                auto new_root = new inner_node();
+                new_root->leaf = false;
+                new_root->count = 1;
+                new_root->keys[0] = split.key;
+                new_root->children[0] = root;
+                new_root->children[1] = split.right;
+                root = new_root;
+            }
+
+            if(inserted.second){
+                ++size_;
+            }
+
+            return inserted;
+        }
+
+    private:
+        node* root = nullptr;
+        leaf_node* first = nullptr;
+        std::size_t size_ = 0;
+        Compare compare;
+
+        // new right sibling of a split node and its first element
+        struct split_result {
+            node* right = nullptr;
+            T key;
+        };
+
+        std::pair<iterator, bool> insert(node* current, const T& value, split_result& split){
+            if(current->leaf){
+                return insert_leaf(static_cast<leaf_node*>(current), value, split);
+            }
+
+            auto inner = static_cast<inner_node*>(current);
+            auto i = std::upper_bound(inner->keys, inner->keys + inner->count, value, compare) - inner->keys;
+
+            split_result child_split;
+            auto inserted = insert(inner->children[i], value, child_split);
+
+            if(child_split.right){
+                insert_inner(inner, i, child_split, split);
+            }
+
+            return inserted;
+        }
+
+        std::pair<iterator, bool> insert_leaf(leaf_node* leaf, const T& value, split_result& split){
+            auto i = std::lower_bound(leaf->values, leaf->values + leaf->count, value, compare) - leaf->values;
+
+            if(i < static_cast<std::ptrdiff_t>(leaf->count) && !compare(value, leaf->values[i])){
+                return {iterator(leaf, i), false};
+            }
+
+            if(leaf->count == Fanout){
+                auto right = new leaf_node();
+                right->leaf = true;
+                right->count = Fanout - Fanout / 2;
+                right->next = leaf->next;
+
+                std::move(leaf->values + Fanout / 2, leaf->values + Fanout, right->values);
+                leaf->count = Fanout / 2;
+                leaf->next = right;
+
+                split.right = right;
+
+                if(i > static_cast<std::ptrdiff_t>(leaf->count)){
+                    i -= leaf->count;
+                    leaf = right;
+                }
+            }
+
+            std::move_backward(leaf->values + i, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->values[i] = value;
+            ++leaf->count;
+
+            if(split.right){
+                split.key = static_cast<leaf_node*>(split.right)->values[0];
+            }
+
+            return {iterator(leaf, i), true};
+        }
+
+        // add the right sibling of children[i] to inner, splitting it when full
+        void insert_inner(inner_node* inner, std::size_t i, const split_result& child, split_result& split){
+            if(inner->count == Fanout){
+                // the middle key goes up, the keys after it go to the right node
+                auto right = new inner_node();
+                right->leaf = false;
+
+                const std::size_t middle = Fanout / 2;
+
+                // the new key and child are placed into a complete sequence first
+                T keys[Fanout + 1];
+                node* children[Fanout + 2];
+
+                std::move(inner->keys, inner->keys + i, keys);
+                keys[i] = child.key;
+                std::move(inner->keys + i, inner->keys + Fanout, keys + i + 1);
+
+                std::copy(inner->children, inner->children + i + 1, children);
+                children[i + 1] = child.right;
+                std::copy(inner->children + i + 1, inner->children + Fanout + 1, children + i + 2);
+
+                inner->count = middle;
+                std::move(keys, keys + middle, inner->keys);
+                std::copy(children, children + middle + 1, inner->children);
+
+                right->count = Fanout - middle;
+                std::move(keys + middle + 1, keys + Fanout + 1, right->keys);
+                std::copy(children + middle + 1, children + Fanout + 2, right->children);
+
+                split.right = right;
+                split.key = keys[middle];
+
+                return;
+            }
+
+            std::move_backward(inner->keys + i, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children + i + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+
+            inner->keys[i] = child.key;
+            inner->children[i + 1] = child.right;
+            ++inner->count;
+        }
+
+        static void destroy(node* current){
+            if(!current){
+                return;
+            }
+
+            if(current->leaf){
+                delete static_cast<leaf_node*>(current);
+            } else {
+                auto inner = static_cast<inner_node*>(current);
+
+                for(std::size_t i = 0; i <= inner->count; ++i){
+                    destroy(inner->children[i]);
+                }
+
+                delete inner;
+            }
+        }
+};
+
+} //end of namespace containers
+
+#endif
@@ -0,0 +1,120 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_EYTZINGER
+#define ARTICLES_EYTZINGER
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+namespace containers {
+
+// Static sorted set in the Eytzinger (breadth first) layout.
+//
+// The element k has its children at 2k and 2k + 1 (1-based), so the
+// binary search goes forward in memory, the first levels share the same
+// cache lines and the descendants four levels down are contiguous and
+// can be prefetched. The elements cannot be modified after construction
+// and the iteration is in layout order, not in sorted order.
+
+template<typename T, typename Compare = std::less<T>>
+class eytzinger_array {
+    public:
+        typedef T value_type;
+        typedef const T* iterator;
+        typedef iterator const_iterator;
+
+        explicit eytzinger_array(Compare compare = Compare()) : values(1), compare(compare) {}
+
+        template<typename Iterator>
+        eytzinger_array(Iterator first, Iterator last, Compare compare = Compare()) : compare(compare) {
+            std::vector<T> sorted(first, last);
+            std::sort(sorted.begin(), sorted.end(), compare);
+
+            values.resize(sorted.size() + 1);
+
+            std::size_t i = 0;
+            build(sorted, i, 1);
+        }
+
+        iterator begin() const {
+            return values.data() + 1;
+        }
+
+        iterator end() const {
+            return values.data() + values.size();
+        }
+
+        std::size_t size() const {
+            return values.size() - 1;
+        }
+
+        bool empty() const {
+            return values.size() == 1;
+        }
+
+        // first element not less than value, end() if none
+        iterator lower_bound(const T& value) const {
+            const std::size_t n = size();
+            const T* data = values.data();
+
+            std::size_t k = 1;
+
+            while(k <= n){
+#ifdef __GNUC__
+                __builtin_prefetch(data + std::min(16 * k, n));
+#endif
+                k = 2 * k + compare(data[k], value);
+            }
+
+            // the answer is the last node where the search went left,
+            // the trailing ones of k are the right turns after it
+            k >>= trailing_ones(k) + 1;
+
+            return k ? data + k : end();
+        }
+
+        iterator find(const T& value) const {
+            auto it = lower_bound(value);
+            return it != end() && !compare(value, *it) ? it : end();
+        }
+
+        std::size_t count(const T& value) const {
+            return find(value) != end();
+        }
+
+    private:
+        std::vector<T> values;  // values[0] is not used
+        Compare compare;
+
+        void build(const std::vector<T>& sorted, std::size_t& i, std::size_t k){
+            if(k <= sorted.size()){
+                build(sorted, i, 2 * k);
+                values[k] = sorted[i++];
+                build(sorted, i, 2 * k + 1);
+            }
+        }
+
+        static std::size_t trailing_ones(std::size_t k){
+#ifdef __GNUC__
+            return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+            std::size_t ones = 0;
+            while(k & 1){
+                k >>= 1;
+                ++ones;
+            }
+            return ones;
+#endif
+        }
+};
+
+} //end of namespace containers
+
+#endif
@@ -0,0 +1,426 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_FLAT_HASH_SET
+#define ARTICLES_FLAT_HASH_SET
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace containers {
+
+// Open addressing hash set with the elements stored inline in one array.
+//
+// One metadata byte per slot, stored apart from the elements, tells if the
+// slot is empty, deleted or full and, when full, holds 7 bits of the hash.
+// The slots are probed by groups of 16: the metadata of a group is compared
+// at once (with SSE2 when available) and only the elements whose 7 bits
+// match are compared with the searched value. The groups are visited with
+// a triangular sequence, the table is grown at 7/8 of occupation.
+
+template<typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class flat_hash_set {
+    private:
+        static const std::size_t group_width = 16;
+
+        static const signed char empty_slot = -128;
+        static const signed char deleted_slot = -2;
+
+        static_assert(alignof(T) <= group_width, "The elements are stored right after the metadata");
+
+        // metadata of one group of slots
+        struct group {
+#ifdef __SSE2__
+            __m128i metadata;
+
+            explicit group(const signed char* p) : metadata(_mm_load_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+            unsigned int match(signed char h2) const {
+                return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), metadata));
+            }
+
+            unsigned int match_empty_or_deleted() const {
+                return _mm_movemask_epi8(_mm_cmplt_epi8(metadata, _mm_set1_epi8(-1)));
+            }
+#else
+            const signed char* metadata;
+
+            explicit group(const signed char* p) : metadata(p) {}
+
+            unsigned int match(signed char h2) const {
+                unsigned int mask = 0;
+                for(std::size_t i = 0; i < group_width; ++i){
+                    mask |= static_cast<unsigned int>(metadata[i] == h2) << i;
+                }
+                return mask;
+            }
+
+            unsigned int match_empty_or_deleted() const {
+                unsigned int mask = 0;
+                for(std::size_t i = 0; i < group_width; ++i){
+                    mask |= static_cast<unsigned int>(metadata[i] < -1) << i;
+                }
+                return mask;
+            }
+#endif
+
+            unsigned int match_empty() const {
+                return match(empty_slot);
+            }
+        };
+
+        static std::size_t lowest_bit(unsigned int mask){
+#ifdef __GNUC__
+            return __builtin_ctz(mask);
+#else
+            std::size_t i = 0;
+            while(!(mask & 1)){
+                mask >>= 1;
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+    public:
+        typedef T value_type;
+        typedef T key_type;
+        typedef std::size_t size_type;
+
+        class iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef const T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const T* pointer;
+                typedef const T& reference;
+
+                iterator() = default;
+
+                const T& operator*() const {
+                    return *slot;
+                }
+
+                const T* operator->() const {
+                    return slot;
+                }
+
+                iterator& operator++(){
+                    ++metadata;
+                    ++slot;
+                    skip();
+                    return *this;
+                }
+
+                iterator operator++(int){
+                    iterator it = *this;
+                    ++*this;
+                    return it;
+                }
+
+                bool operator==(const iterator& rhs) const {
+                    return slot == rhs.slot;
+                }
+
+                bool operator!=(const iterator& rhs) const {
+                    return slot != rhs.slot;
+                }
+
+            private:
+                const signed char* metadata = nullptr;
+                const signed char* last = nullptr;
+                const T* slot = nullptr;
+
+                iterator(const signed char* metadata, const signed char* last, const T* slot) : metadata(metadata), last(last), slot(slot) {}
+
+                void skip(){
+                    while(metadata != last && *metadata < 0){
+                        ++metadata;
+                        ++slot;
+                    }
+                }
+
+                friend class flat_hash_set;
+        };
+
+        typedef iterator const_iterator;
+
+        flat_hash_set() = default;
+
+        flat_hash_set(const flat_hash_set& rhs) : hash(rhs.hash), equal(rhs.equal) {
+            reserve(rhs.size());
+
+            for(auto& value : rhs){
+                insert(value);
+            }
+        }
+
+        flat_hash_set(flat_hash_set&& rhs) noexcept : flat_hash_set() {
+            swap(rhs);
+        }
+
+        flat_hash_set& operator=(flat_hash_set rhs){
+            swap(rhs);
+            return *this;
+        }
+
+        ~flat_hash_set(){
+            destroy();
+            ::operator delete(metadata);
+        }
+
+        void swap(flat_hash_set& rhs) noexcept {
+            std::swap(metadata, rhs.metadata);
+            std::swap(slots, rhs.slots);
+            std::swap(capacity_, rhs.capacity_);
+            std::swap(size_, rhs.size_);
+            std::swap(growth_left, rhs.growth_left);
+            std::swap(hash, rhs.hash);
+            std::swap(equal, rhs.equal);
+        }
+
+        iterator begin() const {
+            iterator it(metadata, metadata + capacity_, slots);
+            it.skip();
+            return it;
+        }
+
+        iterator end() const {
+            return iterator(metadata + capacity_, metadata + capacity_, slots + capacity_);
+        }
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        std::size_t capacity() const {
+            return capacity_;
+        }
+
+        iterator find(const T& value) const {
+            auto i = find_index(value, hash_of(value));
+            return i == capacity_ ? end() : at(i);
+        }
+
+        std::size_t count(const T& value) const {
+            return find_index(value, hash_of(value)) != capacity_;
+        }
+
+        std::pair<iterator, bool> insert(const T& value){
+            return emplace_value(value);
+        }
+
+        std::pair<iterator, bool> insert(T&& value){
+            return emplace_value(std::move(value));
+        }
+
+        std::size_t erase(const T& value){
+            auto i = find_index(value, hash_of(value));
+
+            if(i == capacity_){
+                return 0;
+            }
+
+            slots[i].~T();
+            --size_;
+
+            // A lookup only goes past a group without empty slot, if this
+            // group still has one, no element was placed after it
+            if(group(metadata + i / group_width * group_width).match_empty()){
+                metadata[i] = empty_slot;
+                ++growth_left;
+            } else {
+                metadata[i] = deleted_slot;
+            }
+
+            return 1;
+        }
+
+        void clear(){
+            destroy();
+
+            if(capacity_){
+                std::memset(metadata, static_cast<unsigned char>(empty_slot), capacity_);
+            }
+
+            size_ = 0;
+            growth_left = max_load(capacity_);
+        }
+
+        void reserve(std::size_t n){
+            std::size_t capacity = group_width;
+            while(max_load(capacity) < n){
+                capacity *= 2;
+            }
+
+            if(capacity > capacity_){
+                rehash(capacity);
+            }
+        }
+
+    private:
+        signed char* metadata = nullptr;    // capacity_ bytes, followed by the slots
+        T* slots = nullptr;
+        std::size_t capacity_ = 0;          // 0 or a power of two multiple of group_width
+        std::size_t size_ = 0;
+        std::size_t growth_left = 0;        // empty slots to fill before a rehash
+        Hash hash;
+        KeyEqual equal;
+
+        static std::size_t max_load(std::size_t capacity){
+            return capacity - capacity / 8;
+        }
+
+        // mix the bits of weak hashes (e.g. identity of integers)
+        std::size_t hash_of(const T& value) const {
+            auto h = static_cast<std::uint64_t>(hash(value)) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<std::size_t>(h ^ h >> 32);
+        }
+
+        static signed char h2(std::size_t h){
+            return static_cast<signed char>(h & 0x7F);
+        }
+
+        iterator at(std::size_t i) const {
+            return iterator(metadata + i, metadata + capacity_, slots + i);
+        }
+
+        std::size_t find_index(const T& value, std::size_t h) const {
+            if(!capacity_){
+                return 0;
+            }
+
+            const auto groups = capacity_ / group_width;
+            auto g = (h >> 7) & (groups - 1);
+
+            for(std::size_t probe = 0; probe < groups; ++probe){
+                group candidates(metadata + g * group_width);
+
+                for(auto mask = candidates.match(h2(h)); mask; mask &= mask - 1){
+                    auto i = g * group_width + lowest_bit(mask);
+
+                    if(equal(slots[i], value)){
+                        return i;
+                    }
+                }
+
+                if(candidates.match_empty()){
+                    break;
+                }
+
+                g = (g + probe + 1) & (groups - 1);
+            }
+
+            return capacity_;
+        }
+
+        // first empty or deleted slot of the probe sequence of h
+        std::size_t find_free(std::size_t h) const {
+            const auto groups = capacity_ / group_width;
+            auto g = (h >> 7) & (groups - 1);
+
+            for(std::size_t probe = 0;; ++probe){
+                auto mask = group(metadata + g * group_width).match_empty_or_deleted();
+
+                if(mask){
+                    return g * group_width + lowest_bit(mask);
+                }
+
+                g = (g + probe + 1) & (groups - 1);
+            }
+        }
+
+        template<typename V>
+        std::pair<iterator, bool> emplace_value(V&& value){
+            auto h = hash_of(value);
+            auto i = find_index(value, h);
+
+            if(i != capacity_){
+                return {at(i), false};
+            }
+
+            if(!growth_left){
+                // only clean the deleted slots if they are many
+                rehash(size_ < max_load(capacity_) / 2 ? capacity_ : std::max(capacity_ * 2, group_width));
+            }
+
+            i = find_free(h);
+
+            if(metadata[i] == empty_slot){
+                --growth_left;
+            }
+
+            new (slots + i) T(std::forward<V>(value));
+            metadata[i] = h2(h);
+            ++size_;
+
+            return {at(i), true};
+        }
+
+        void rehash(std::size_t capacity){
+            auto old_metadata = metadata;
+            auto old_slots = slots;
+            auto old_capacity = capacity_;
+
+            metadata = static_cast<signed char*>(::operator new(capacity + capacity * sizeof(T)));
+            slots = reinterpret_cast<T*>(metadata + capacity);
+            capacity_ = capacity;
+            growth_left = max_load(capacity) - size_;
+
+            std::memset(metadata, static_cast<unsigned char>(empty_slot), capacity);
+
+            for(std::size_t i = 0; i < old_capacity; ++i){
+                if(old_metadata[i] >= 0){
+                    auto h = hash_of(old_slots[i]);
+                    auto j = find_free(h);
+
+                    new (slots + j) T(std::move(old_slots[i]));
+                    metadata[j] = h2(h);
+                    old_slots[i].~T();
+                }
+            }
+
+            ::operator delete(old_metadata);
+        }
+
+        void destroy(){
+            if(!std::is_trivially_destructible<T>::value){
+                for(std::size_t i = 0; i < capacity_; ++i){
+                    if(metadata[i] >= 0){
+                        slots[i].~T();
+                    }
+                }
+            }
+        }
+};
+
+template<typename T, typename Hash, typename KeyEqual>
+const std::size_t flat_hash_set<T, Hash, KeyEqual>::group_width;
+
+template<typename T, typename Hash, typename KeyEqual>
+const signed char flat_hash_set<T, Hash, KeyEqual>::empty_slot;
+
+template<typename T, typename Hash, typename KeyEqual>
+const signed char flat_hash_set<T, Hash, KeyEqual>::deleted_slot;
+
+} //end of namespace containers
+
+#endif
@@ -0,0 +1,140 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_GENERATORS
+#define ARTICLES_GENERATORS
+
+#include <random>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+// Input generators for the sort benchmarks
+
+namespace generators {
+
+enum class Distribution : unsigned int {
+    UNIFORM,        // uniform values in [0, max]
+    SHUFFLED,       // random permutation of [0, size)
+    ZIPF,           // value k with a probability in 1 / (k + 1)
+    MOSTLY_SORTED,  // sorted uniform values with 1% of them swapped
+    REVERSE_SORTED, // uniform values sorted in decreasing order
+    FEW_UNIQUE,     // at most 100 different values spread over [0, max]
+    SAWTOOTH        // 16 increasing runs over [0, max]
+};
+
+static const std::array<Distribution, 7> all_distributions {{
+    Distribution::UNIFORM,
+    Distribution::SHUFFLED,
+    Distribution::ZIPF,
+    Distribution::MOSTLY_SORTED,
+    Distribution::REVERSE_SORTED,
+    Distribution::FEW_UNIQUE,
+    Distribution::SAWTOOTH
+}};
+
+// seed of the default constructed std::mt19937
+static const std::size_t default_seed = std::mt19937::default_seed;
+
+inline const char* name(Distribution d){
+    switch(d){
+        case Distribution::UNIFORM:         return "uniform";
+        case Distribution::SHUFFLED:        return "shuffled";
+        case Distribution::ZIPF:            return "zipf";
+        case Distribution::MOSTLY_SORTED:   return "mostly_sorted";
+        case Distribution::REVERSE_SORTED:  return "reverse_sorted";
+        case Distribution::FEW_UNIQUE:      return "few_unique";
+        case Distribution::SAWTOOTH:        return "sawtooth";
+    }
+
+    return "unknown";
+}
+
+// append size values drawn from d to vec
+inline void fill(std::vector<std::size_t>& vec, std::size_t size, std::size_t max, Distribution d, std::size_t seed = default_seed){
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<std::size_t> uniform(0, max);
+
+    auto first = vec.size();
+
+    switch(d){
+        case Distribution::UNIFORM:
+        case Distribution::MOSTLY_SORTED:
+        case Distribution::REVERSE_SORTED:
+            for(std::size_t i = 0; i < size; ++i){
+                vec.push_back(uniform(generator));
+            }
+
+            break;
+
+        case Distribution::SHUFFLED:
+            vec.resize(first + size);
+            std::iota(vec.begin() + first, vec.end(), std::size_t(0));
+            std::shuffle(vec.begin() + first, vec.end(), generator);
+            break;
+
+        case Distribution::ZIPF: {
+            // inversion of the continuous density 1 / x over [1, max + 2)
+            std::uniform_real_distribution<double> real(0.0, 1.0);
+            const double log_range = std::log(static_cast<double>(max) + 2.0);
+
+            for(std::size_t i = 0; i < size; ++i){
+                auto value = static_cast<std::size_t>(std::exp(real(generator) * log_range)) - 1;
+                vec.push_back(std::min(value, max));
+            }
+
+            break;
+        }
+
+        case Distribution::FEW_UNIQUE: {
+            std::uniform_int_distribution<std::size_t> few(0, 99);
+
+            // k * max / 99, split so that it cannot overflow
+            const std::size_t step = max / 99;
+            const std::size_t rest = max % 99;
+
+            for(std::size_t i = 0; i < size; ++i){
+                auto k = few(generator);
+                vec.push_back(k * step + k * rest / 99);
+            }
+
+            break;
+        }
+
+        case Distribution::SAWTOOTH: {
+            const std::size_t period = std::max<std::size_t>(1, size / 16);
+
+            for(std::size_t i = 0; i < size; ++i){
+                vec.push_back(static_cast<std::size_t>(static_cast<double>(i % period) / period * max));
+            }
+
+            break;
+        }
+    }
+
+    if(d == Distribution::MOSTLY_SORTED || d == Distribution::REVERSE_SORTED){
+        std::sort(vec.begin() + first, vec.end());
+    }
+
+    if(d == Distribution::REVERSE_SORTED){
+        std::reverse(vec.begin() + first, vec.end());
+    }
+
+    if(d == Distribution::MOSTLY_SORTED && size > 1){
+        std::uniform_int_distribution<std::size_t> position(first, vec.size() - 1);
+
+        for(std::size_t i = 0; i < size / 200; ++i){
+            std::swap(vec[position(generator)], vec[position(generator)]);
+        }
+    }
+}
+
+} //end of namespace generators
+
+#endif
@@ -14,10 +14,46 @@
 
 namespace graphs {
 
+// statistics of the timings of one result, in nanoseconds
+struct statistics {
+    std::size_t iterations;
+    double min;
+    double median;
+    double mean;
+    double p90;
+    double stddev;
+};
+
+// hardware performance counters of one result, per iteration, negative
+// when the counter is not available
+struct counters {
+    double cycles;
+    double instructions;
+    double cache_misses;
+    double branch_misses;
+    double dtlb_misses;
+};
+
+counters unavailable_counters();
+
+// heap allocations of one result, in one untimed iteration, negative when not tracked
+struct allocations {
+    double count;
+    double bytes;       // requested bytes
+    double peak_bytes;  // peak of the live heap bytes allocated during the iteration
+    double time;        // nanoseconds spent in operator new and delete
+};
+
+allocations unavailable_allocations();
+
 struct result {
     std::string serie;
     std::string group;
     std::size_t value;
+    statistics stats;
+    counters hw;
+    std::vector<double> samples;    // in nanoseconds
+    allocations heap;
 };
 
 struct graph {
@@ -30,14 +66,27 @@ struct graph {
 };
 
 enum class Output : unsigned int {
-    GOOGLE,
-    PLUGIN
+    GOOGLE,     // graph.html, Google Charts page
+    PLUGIN,     // graph.html, WordPress shortcodes
+    JSON,       // graph.json, all the results with their statistics and samples
+    CSV         // graph.csv, one line per result
 };
 
 void new_graph(const std::string& graph_name, const std::string& graph_title, const std::string& unit);
-void new_result(const std::string& serie, const std::string& group, std::size_t value);
+void new_result(const std::string& serie, const std::string& group, std::size_t value,
+    const statistics& stats = statistics(), const counters& hw = unavailable_counters(),
+    const std::vector<double>& samples = std::vector<double>(), const allocations& heap = unavailable_allocations());
 void output(Output output);
 
+// comparison with a baseline run, stored as the graph.csv of a previous run
+
+bool load_baseline(const std::string& file);
+
+// print the results whose median is more than threshold slower than in the
+// baseline, with a one-sided Mann-Whitney p-value lower than alpha, and
+// return their number
+std::size_t check_regressions(double threshold = 0.05, double alpha = 0.01);
+
 }
 
 #endif
@@ -0,0 +1,45 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_ISOLATION
+#define ARTICLES_ISOLATION
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "graphs.hpp"
+
+namespace isolation {
+
+struct settings {
+    bool enabled;       // run each benchmark cell in a forked process
+    int cpu;            // core to pin the benchmark to, -1 to let it migrate
+    bool lock_memory;   // lock the memory of the benchmark process
+};
+
+settings& current();
+
+// samples (in nanoseconds), hardware counters and heap allocations of one
+// benchmark cell
+struct measurement {
+    std::vector<double> samples;
+    graphs::counters hw;
+    graphs::allocations heap;
+};
+
+// pin and lock the current process as configured, returns false if any fails
+bool apply();
+
+// run measure() in a fresh child process, pinned and locked as configured,
+// and collect its measurement over a pipe. Runs it in the current process
+// if isolation is disabled or not supported.
+bool run(const std::function<measurement()>& measure, measurement& result);
+
+} //end of namespace isolation
+
+#endif
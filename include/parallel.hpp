@@ -0,0 +1,152 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_PARALLEL
+#define ARTICLES_PARALLEL
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Fixed set of worker threads running indexed tasks.
+//
+// The threads are started once and wait between two jobs, so a job only
+// costs a wake up instead of the creation of the threads. The calling
+// thread takes part in the job as well.
+
+class thread_pool {
+    public:
+        explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency()){
+            // the calling thread is the first worker
+            for(std::size_t i = 1; i < threads; ++i){
+                workers.emplace_back([this](){ work(); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+
+            job_ready.notify_all();
+
+            for(auto& worker : workers){
+                worker.join();
+            }
+        }
+
+        // number of threads running the jobs, the calling one included
+        std::size_t size() const {
+            return workers.size() + 1;
+        }
+
+        // run task(i) for every i in [0, n) and wait for all of them, the
+        // tasks must not throw
+        void parallel_for(std::size_t n, const std::function<void(std::size_t)>& task){
+            if(workers.empty() || n < 2){
+                for(std::size_t i = 0; i < n; ++i){
+                    task(i);
+                }
+
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current_task = &task;
+                tasks = n;
+                next_task = 0;
+                running = workers.size();
+                ++generation;
+            }
+
+            job_ready.notify_all();
+
+            run_tasks(task, n);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            job_done.wait(lock, [this](){ return running == 0; });
+            current_task = nullptr;
+        }
+
+    private:
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable job_ready;
+        std::condition_variable job_done;
+
+        const std::function<void(std::size_t)>* current_task = nullptr;
+        std::size_t tasks = 0;
+        std::size_t running = 0;
+        std::size_t generation = 0;
+        bool stop = false;
+
+        std::atomic<std::size_t> next_task{0};
+
+        void run_tasks(const std::function<void(std::size_t)>& task, std::size_t n){
+            for(std::size_t i = next_task++; i < n; i = next_task++){
+                task(i);
+            }
+        }
+
+        void work(){
+            std::size_t seen = 0;
+
+            while(true){
+                const std::function<void(std::size_t)>* task;
+                std::size_t n;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    job_ready.wait(lock, [&](){ return stop || generation != seen; });
+
+                    if(stop){
+                        return;
+                    }
+
+                    seen = generation;
+                    task = current_task;
+                    n = tasks;
+                }
+
+                run_tasks(*task, n);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if(--running == 0){
+                    job_done.notify_one();
+                }
+            }
+        }
+};
+
+// Call function on every element of a segmented container (see
+// plf::colony::for_each_segment), the segments being spread over the
+// threads of the pool. The function is called concurrently on different
+// elements and must not throw.
+template<typename Container, typename Function>
+void for_each(thread_pool& pool, Container& container, Function function){
+    std::vector<typename Container::segment> segments;
+
+    container.for_each_segment([&segments](const typename Container::segment& segment){ segments.push_back(segment); });
+
+    pool.parallel_for(segments.size(), [&segments, &function](std::size_t i){ segments[i].for_each(function); });
+}
+
+} //end of namespace parallel
+
+#endif
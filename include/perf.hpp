@@ -0,0 +1,43 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_PERF
+#define ARTICLES_PERF
+
+#include <vector>
+
+#include "graphs.hpp"
+
+namespace perf {
+
+// Group of hardware performance counters (cycles, instructions, cache
+// misses, branch misses and dTLB misses) of the current thread, based on
+// perf_event_open. The counters that cannot be opened (unsupported
+// hardware, restrictive perf_event_paranoid, other platforms) are
+// reported as not available.
+
+class counter_group {
+    public:
+        counter_group();
+        ~counter_group();
+
+        counter_group(const counter_group&) = delete;
+        counter_group& operator=(const counter_group&) = delete;
+
+        bool available() const;
+
+        void start();
+        graphs::counters stop();
+
+    private:
+        std::vector<int> fds;
+        int leader;
+};
+
+} //end of namespace perf
+
+#endif
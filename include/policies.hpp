@@ -7,6 +7,9 @@
 
 #include <boost/intrusive/list.hpp>
 
+#include "generators.hpp"
+#include "parallel.hpp"
+
 // create policies
 
 //Create empty container
@@ -53,19 +56,43 @@ struct Filled {
     inline static void clean(){}
 };
 
+//Distribution of the values of the FilledRandom and FilledRandomInsert
+//containers, a permutation of all the integers from the range by default
+
+inline generators::Distribution& fill_distribution(){
+    static generators::Distribution distribution = generators::Distribution::SHUFFLED;
+    return distribution;
+}
+
+inline std::size_t& fill_seed(){
+    static std::size_t seed = generators::default_seed;
+    return seed;
+}
+
+template<typename T>
+void prepare_random(std::vector<T>& v, std::size_t size, generators::Distribution& distribution, std::size_t& seed){
+    if(v.size() != size || distribution != fill_distribution() || seed != fill_seed()){
+        distribution = fill_distribution();
+        seed = fill_seed();
+
+        std::vector<std::size_t> values;
+        generators::fill(values, size, size - 1, distribution, seed);
+
+        v.clear();
+        v.reserve(size);
+        for(auto value : values){
+            v.push_back({value});
+        }
+    }
+}
+
 template<class Container>
 struct FilledRandom {
     static std::vector<typename Container::value_type> v;
+    static generators::Distribution distribution;
+    static std::size_t seed;
     inline static Container make(std::size_t size){
-        // prepare randomized data that will have all the integers from the range
-        if(v.size() != size){
-            v.clear();
-            v.reserve(size);
-            for(std::size_t i = 0; i < size; ++i){
-                v.push_back({i});
-            }
-            std::shuffle(begin(v), end(v), std::mt19937());
-        }
+        prepare_random(v, size, distribution, seed);
 
         // fill with randomized data
         Container container;
@@ -85,19 +112,19 @@ struct FilledRandom {
 template<class Container>
 std::vector<typename Container::value_type> FilledRandom<Container>::v;
 
+template<class Container>
+generators::Distribution FilledRandom<Container>::distribution;
+
+template<class Container>
+std::size_t FilledRandom<Container>::seed;
+
 template<class Container>
 struct FilledRandomInsert {
     static std::vector<typename Container::value_type> v;
+    static generators::Distribution distribution;
+    static std::size_t seed;
     inline static Container make(std::size_t size){
-        // prepare randomized data that will have all the integers from the range
-        if(v.size() != size){
-            v.clear();
-            v.reserve(size);
-            for(std::size_t i = 0; i < size; ++i){
-                v.push_back({i});
-            }
-            std::shuffle(begin(v), end(v), std::mt19937());
-        }
+        prepare_random(v, size, distribution, seed);
 
         // fill with randomized data
         Container container;
@@ -117,6 +144,55 @@ struct FilledRandomInsert {
 template<class Container>
 std::vector<typename Container::value_type> FilledRandomInsert<Container>::v;
 
+template<class Container>
+generators::Distribution FilledRandomInsert<Container>::distribution;
+
+template<class Container>
+std::size_t FilledRandomInsert<Container>::seed;
+
+//Same data as FilledRandom, given at once to the constructor
+
+template<class Container>
+struct FilledRandomRange {
+    static std::vector<typename Container::value_type> v;
+    static generators::Distribution distribution;
+    static std::size_t seed;
+    inline static Container make(std::size_t size){
+        prepare_random(v, size, distribution, seed);
+
+        return Container(v.begin(), v.end());
+    }
+
+    inline static void clean(){
+        v.clear();
+        v.shrink_to_fit();
+    }
+};
+
+template<class Container>
+std::vector<typename Container::value_type> FilledRandomRange<Container>::v;
+
+template<class Container>
+generators::Distribution FilledRandomRange<Container>::distribution;
+
+template<class Container>
+std::size_t FilledRandomRange<Container>::seed;
+
+//Same data as FilledRandom, sorted for the binary searches
+
+template<class Container>
+struct FilledRandomSorted {
+    inline static Container make(std::size_t size){
+        auto container = FilledRandom<Container>::make(size);
+        std::sort(std::begin(container), std::end(container));
+        return container;
+    }
+
+    inline static void clean(){
+        FilledRandom<Container>::clean();
+    }
+};
+
 template<class Container>
 struct SmartFilled {
     inline static std::unique_ptr<Container> make(std::size_t size){
@@ -185,6 +261,34 @@ struct InsertSimple {
 template<class Container>
 const typename Container::value_type InsertSimple<Container>::value{};
 
+//Insert all the elements at once, as copies of one value or from a range
+
+template<class Container>
+struct InsertFill {
+    static const typename Container::value_type value;
+    inline static void run(Container &c, std::size_t size){
+        c.insert(size, value);
+    }
+};
+
+template<class Container>
+const typename Container::value_type InsertFill<Container>::value{};
+
+template<class Container>
+struct InsertRange {
+    static std::vector<typename Container::value_type> values;
+    inline static void run(Container &c, std::size_t size){
+        if(values.size() < size){
+            values.resize(size);
+        }
+
+        c.insert(values.begin(), values.begin() + size);
+    }
+};
+
+template<class Container>
+std::vector<typename Container::value_type> InsertRange<Container>::values;
+
 template<class Container>
 struct FillBack {
     static const typename Container::value_type value;
@@ -207,6 +311,46 @@ struct FillBackBackup {
     }
 };
 
+//Build and destroy small containers one after the other
+
+template<class Container>
+struct FillBackRepeat {
+    static const std::size_t repeat = 100000;
+    static std::size_t X;
+    inline static void run(Container &, std::size_t size){
+        for(std::size_t i=0; i<repeat; ++i){
+            Container local;
+            for(std::size_t j=0; j<size; ++j){
+                local.push_back({j});
+            }
+            X += local[X % size].a;
+        }
+    }
+};
+
+template<class Container>
+std::size_t FillBackRepeat<Container>::X = 0;
+
+//Build many small containers alive at the same time, then destroy them
+
+template<class Container>
+struct FillBackMany {
+    static const std::size_t count = 1000000;
+    static std::size_t X;
+    inline static void run(Container &, std::size_t size){
+        std::vector<Container> containers(count);
+        for(auto& local : containers){
+            for(std::size_t j=0; j<size; ++j){
+                local.push_back({j});
+            }
+        }
+        X += containers[X % count][X % size].a;
+    }
+};
+
+template<class Container>
+std::size_t FillBackMany<Container>::X = 0;
+
 template<class Container>
 struct FillBackInserter {
     static const typename Container::value_type value;
@@ -291,6 +435,81 @@ struct Find {
 template<class Container>
 size_t Find<Container>::X = 0;
 
+//Find in an associative container
+
+template<class Container>
+struct SetFind {
+    static size_t X;
+    inline static void run(Container &c, std::size_t size){
+        typename Container::value_type key;
+        for(std::size_t i=0; i<size; ++i) {
+            key.a = i;
+            if(c.find(key) == c.end()){
+                ++X;
+            }
+        }
+    }
+};
+
+template<class Container>
+size_t SetFind<Container>::X = 0;
+
+//Find in a sorted container
+
+template<class Container>
+struct BinaryFind {
+    static size_t X;
+    inline static void run(Container &c, std::size_t size){
+        for(std::size_t i=0; i<size; ++i) {
+            // hand written comparison to eliminate temporary object creation
+            auto it = std::lower_bound(std::begin(c), std::end(c), i, [](decltype(*std::begin(c)) v, std::size_t i){ return v.a < i; });
+            if(it == std::end(c) || it->a != i){
+                ++X;
+            }
+        }
+    }
+};
+
+template<class Container>
+size_t BinaryFind<Container>::X = 0;
+
+//Find in a sorted container with pending insertions, without merging them
+
+template<class Container>
+struct SortedContains {
+    static size_t X;
+    inline static void run(Container &c, std::size_t size){
+        typename Container::value_type key;
+        for(std::size_t i=0; i<size; ++i) {
+            key.a = i;
+            if(!c.contains(key)){
+                ++X;
+            }
+        }
+    }
+};
+
+template<class Container>
+size_t SortedContains<Container>::X = 0;
+
+//Find with the container's own find_if, which skips the erased elements
+//a group at a time and stops at the first match
+
+template<class Container>
+struct MemberFindIf {
+    static size_t X;
+    inline static void run(Container &c, std::size_t size){
+        for(std::size_t i=0; i<size; ++i) {
+            if(c.find_if([&](const typename Container::value_type& v){ return v.a == i; }) == c.end()){
+                ++X;
+            }
+        }
+    }
+};
+
+template<class Container>
+size_t MemberFindIf<Container>::X = 0;
+
 template<class Container>
 struct Insert {
     static std::array<typename Container::value_type, 1000> values;
@@ -318,6 +537,39 @@ struct Write {
     }
 };
 
+template<class Container>
+struct ForEachWrite {
+    inline static void run(Container &c, std::size_t){
+        c.for_each([](typename Container::value_type& v){ ++v.a; });
+    }
+};
+
+//Write with the container's for_each spread over all the cores. The pool
+//is started before the measures, in the process measuring the cell, and
+//the hardware counters, which only see the calling thread, are not
+//reported
+
+template<class Container>
+struct ParallelWrite {
+    static const bool multithreaded = true;
+
+    static parallel::thread_pool& pool(){
+        static parallel::thread_pool pool;
+        return pool;
+    }
+
+    static void prepare(){
+        pool();
+    }
+
+    inline static void run(Container &c, std::size_t){
+        parallel::for_each(pool(), c, [](typename Container::value_type& v){ ++v.a; });
+    }
+};
+
+template<class Container>
+const bool ParallelWrite<Container>::multithreaded;
+
 template<class Container>
 struct Iterate {
     inline static void run(Container &c, std::size_t){
@@ -385,6 +637,13 @@ struct TimSort {
     }
 };
 
+template<class T>
+struct TimSort<std::vector<T> > {
+    inline static void run(std::vector<T> &c, std::size_t){
+        plf::timsort(c.begin(), c.end());
+    }
+};
+
 //Reverse the container
 
 template<class Container>
@@ -432,6 +691,51 @@ struct RandomSortedInsert {
 template<class Container> std::mt19937 RandomSortedInsert<Container>::generator;
 template<class Container> std::uniform_int_distribution<std::size_t> RandomSortedInsert<Container>::distribution(0, std::numeric_limits<std::size_t>::max() - 1);
 
+//Same values as RandomSortedInsert, the position is found with a binary search
+
+template<class Container>
+struct BinarySortedInsert {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t size){
+        for(std::size_t i=0; i<size; ++i){
+            auto val = distribution(generator);
+            // hand written comparison to eliminate temporary object creation
+            c.insert(std::lower_bound(begin(c), end(c), val, [](decltype(*begin(c)) v, std::size_t val){ return v.a < val; }), {val});
+        }
+    }
+};
+
+template<class Container> std::mt19937 BinarySortedInsert<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> BinarySortedInsert<Container>::distribution(0, std::numeric_limits<std::size_t>::max() - 1);
+
+//Same values as RandomSortedInsert, in an associative container
+
+template<class Container>
+struct SetRandomInsert {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t size){
+        for(std::size_t i=0; i<size; ++i){
+            c.insert({distribution(generator)});
+        }
+    }
+};
+
+template<class Container> std::mt19937 SetRandomInsert<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> SetRandomInsert<Container>::distribution(0, std::numeric_limits<std::size_t>::max() - 1);
+
+//Merge the pending insertions of a batched container
+
+template<class Container>
+struct Flush {
+    inline static void run(Container &c, std::size_t){
+        c.flush();
+    }
+};
+
 template<class Container>
 struct RandomErase1 {
     static std::mt19937 generator;
@@ -518,6 +822,60 @@ struct RandomErase50 {
 template<class Container> std::mt19937 RandomErase50<Container>::generator;
 template<class Container> std::uniform_int_distribution<std::size_t> RandomErase50<Container>::distribution(0, 10000);
 
+//Same erasures with the container's erase_if
+
+template<class Container>
+struct RandomEraseIf1 {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t /*size*/){
+        c.erase_if([](const typename Container::value_type&){ return distribution(generator) > 9900; });
+    }
+};
+
+template<class Container> std::mt19937 RandomEraseIf1<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> RandomEraseIf1<Container>::distribution(0, 10000);
+
+template<class Container>
+struct RandomEraseIf10 {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t /*size*/){
+        c.erase_if([](const typename Container::value_type&){ return distribution(generator) > 9000; });
+    }
+};
+
+template<class Container> std::mt19937 RandomEraseIf10<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> RandomEraseIf10<Container>::distribution(0, 10000);
+
+template<class Container>
+struct RandomEraseIf25 {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t /*size*/){
+        c.erase_if([](const typename Container::value_type&){ return distribution(generator) > 7500; });
+    }
+};
+
+template<class Container> std::mt19937 RandomEraseIf25<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> RandomEraseIf25<Container>::distribution(0, 10000);
+
+template<class Container>
+struct RandomEraseIf50 {
+    static std::mt19937 generator;
+    static std::uniform_int_distribution<std::size_t> distribution;
+
+    inline static void run(Container &c, std::size_t /*size*/){
+        c.erase_if([](const typename Container::value_type&){ return distribution(generator) > 5000; });
+    }
+};
+
+template<class Container> std::mt19937 RandomEraseIf50<Container>::generator;
+template<class Container> std::uniform_int_distribution<std::size_t> RandomEraseIf50<Container>::distribution(0, 10000);
+
 // Note: This is probably erased completely for a vector
 template<class Container>
 struct Traversal {
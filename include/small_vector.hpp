@@ -0,0 +1,214 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_SMALL_VECTOR
+#define ARTICLES_SMALL_VECTOR
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace containers {
+
+// Vector with the storage of its first N elements inside the object.
+//
+// Up to N elements, no memory is allocated, creating and destroying the
+// container costs nothing more than the constructors and destructors of
+// the elements. Past N elements, the elements are moved to the heap and
+// the container behaves like a std::vector.
+
+template<typename T, std::size_t N>
+class small_vector {
+    static_assert(N > 0, "The inline capacity cannot be empty");
+
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+        typedef const T* const_iterator;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+
+        small_vector() : first(inline_data()), size_(0), capacity_(N) {}
+
+        explicit small_vector(std::size_t size, const T& value = T()) : small_vector() {
+            reserve(size);
+            std::uninitialized_fill_n(first, size, value);
+            size_ = size;
+        }
+
+        small_vector(const small_vector& rhs) : small_vector() {
+            reserve(rhs.size_);
+            std::uninitialized_copy(rhs.begin(), rhs.end(), first);
+            size_ = rhs.size_;
+        }
+
+        small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) : small_vector() {
+            steal(rhs);
+        }
+
+        small_vector& operator=(const small_vector& rhs){
+            if(this != &rhs){
+                clear();
+                reserve(rhs.size_);
+                std::uninitialized_copy(rhs.begin(), rhs.end(), first);
+                size_ = rhs.size_;
+            }
+
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if(this != &rhs){
+                clear();
+                release();
+                steal(rhs);
+            }
+
+            return *this;
+        }
+
+        ~small_vector(){
+            clear();
+            release();
+        }
+
+        iterator begin(){ return first; }
+        iterator end(){ return first + size_; }
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return first + size_; }
+
+        T& operator[](std::size_t i){ return first[i]; }
+        const T& operator[](std::size_t i) const { return first[i]; }
+
+        T& front(){ return first[0]; }
+        const T& front() const { return first[0]; }
+        T& back(){ return first[size_ - 1]; }
+        const T& back() const { return first[size_ - 1]; }
+
+        T* data(){ return first; }
+        const T* data() const { return first; }
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        std::size_t capacity() const {
+            return capacity_;
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        // true while the elements are stored inside the object
+        bool is_inline() const {
+            return first == inline_data();
+        }
+
+        void reserve(std::size_t capacity){
+            if(capacity > capacity_){
+                grow(capacity);
+            }
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
+        }
+
+        void push_back(T&& value){
+            emplace_back(std::move(value));
+        }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args){
+            if(size_ == capacity_){
+                // the argument may be an element of the container
+                T value(std::forward<Args>(args)...);
+                grow(2 * capacity_);
+                new (first + size_) T(std::move(value));
+            } else {
+                new (first + size_) T(std::forward<Args>(args)...);
+            }
+
+            ++size_;
+        }
+
+        void pop_back(){
+            first[--size_].~T();
+        }
+
+        void clear(){
+            destroy(first, first + size_);
+            size_ = 0;
+        }
+
+    private:
+        T* first;
+        std::size_t size_;
+        std::size_t capacity_;
+        typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type storage;
+
+        T* inline_data(){
+            return reinterpret_cast<T*>(&storage);
+        }
+
+        const T* inline_data() const {
+            return reinterpret_cast<const T*>(&storage);
+        }
+
+        static void destroy(T* begin, T* end){
+            if(!std::is_trivially_destructible<T>::value){
+                for(; begin != end; ++begin){
+                    begin->~T();
+                }
+            }
+        }
+
+        void grow(std::size_t capacity){
+            auto data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+
+            std::uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(first + size_), data);
+            destroy(first, first + size_);
+            release();
+
+            first = data;
+            capacity_ = capacity;
+        }
+
+        // free the heap storage, the container must be empty
+        void release(){
+            if(!is_inline()){
+                ::operator delete(first);
+                first = inline_data();
+                capacity_ = N;
+            }
+        }
+
+        // take the elements of rhs, this container must be empty and inline
+        void steal(small_vector& rhs){
+            if(rhs.is_inline()){
+                std::uninitialized_copy(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()), first);
+                size_ = rhs.size_;
+                rhs.clear();
+            } else {
+                first = rhs.first;
+                size_ = rhs.size_;
+                capacity_ = rhs.capacity_;
+
+                rhs.first = rhs.inline_data();
+                rhs.size_ = 0;
+                rhs.capacity_ = N;
+            }
+        }
+};
+
+} //end of namespace containers
+
+#endif
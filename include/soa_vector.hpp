@@ -0,0 +1,231 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_SOA_VECTOR
+#define ARTICLES_SOA_VECTOR
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace containers {
+
+// Split of T between its hot field a and its cold payload b, to be
+// specialized for each stored type:
+//
+//  typedef ... hot_type;
+//  typedef ... cold_type;
+//  static const hot_type& hot(const T&);
+//  static const cold_type& cold(const T&);
+//  static T join(const hot_type&, const cold_type&);
+
+template<typename T>
+struct soa_traits;
+
+// Sequence of T stored as a structure of arrays: the a fields are
+// contiguous in one vector and the b payloads in another one, so the loops
+// only touching a do not pull the payloads in cache. The elements are
+// accessed through proxies with references to a and b.
+
+template<typename T>
+class soa_vector {
+    private:
+        typedef soa_traits<T> traits;
+
+    public:
+        typedef T value_type;
+        typedef typename traits::hot_type hot_type;
+        typedef typename traits::cold_type cold_type;
+
+        template<typename Hot, typename Cold>
+        struct basic_reference {
+            Hot& a;
+            Cold& b;
+
+            operator T() const {
+                return traits::join(a, b);
+            }
+        };
+
+        struct reference : basic_reference<hot_type, cold_type> {
+            reference(hot_type& a, cold_type& b) : basic_reference<hot_type, cold_type>{a, b} {}
+
+            reference& operator=(const T& value){
+                this->a = traits::hot(value);
+                this->b = traits::cold(value);
+                return *this;
+            }
+        };
+
+        struct const_reference : basic_reference<const hot_type, const cold_type> {
+            const_reference(const hot_type& a, const cold_type& b) : basic_reference<const hot_type, const cold_type>{a, b} {}
+        };
+
+        template<typename Reference, typename Container>
+        class basic_iterator {
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Reference reference;
+
+                // it->a goes through a temporary proxy
+                struct pointer {
+                    Reference proxy;
+
+                    Reference* operator->(){
+                        return &proxy;
+                    }
+                };
+
+                basic_iterator(Container* container, std::size_t index) : container(container), index(index) {}
+
+                Reference operator*() const {
+                    return (*container)[index];
+                }
+
+                pointer operator->() const {
+                    return {**this};
+                }
+
+                Reference operator[](difference_type n) const {
+                    return (*container)[index + n];
+                }
+
+                basic_iterator& operator++(){
+                    ++index;
+                    return *this;
+                }
+
+                basic_iterator operator++(int){
+                    basic_iterator it = *this;
+                    ++index;
+                    return it;
+                }
+
+                basic_iterator& operator--(){
+                    --index;
+                    return *this;
+                }
+
+                basic_iterator operator--(int){
+                    basic_iterator it = *this;
+                    --index;
+                    return it;
+                }
+
+                basic_iterator& operator+=(difference_type n){
+                    index += n;
+                    return *this;
+                }
+
+                basic_iterator& operator-=(difference_type n){
+                    index -= n;
+                    return *this;
+                }
+
+                basic_iterator operator+(difference_type n) const {
+                    return basic_iterator(container, index + n);
+                }
+
+                basic_iterator operator-(difference_type n) const {
+                    return basic_iterator(container, index - n);
+                }
+
+                difference_type operator-(const basic_iterator& rhs) const {
+                    return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index);
+                }
+
+                bool operator==(const basic_iterator& rhs) const { return index == rhs.index; }
+                bool operator!=(const basic_iterator& rhs) const { return index != rhs.index; }
+                bool operator<(const basic_iterator& rhs) const { return index < rhs.index; }
+                bool operator>(const basic_iterator& rhs) const { return index > rhs.index; }
+                bool operator<=(const basic_iterator& rhs) const { return index <= rhs.index; }
+                bool operator>=(const basic_iterator& rhs) const { return index >= rhs.index; }
+
+            private:
+                Container* container;
+                std::size_t index;
+        };
+
+        typedef basic_iterator<reference, soa_vector> iterator;
+        typedef basic_iterator<const_reference, const soa_vector> const_iterator;
+
+        soa_vector() = default;
+
+        explicit soa_vector(std::size_t size, const T& value = T()) : hot_values(size, traits::hot(value)), cold_values(size, traits::cold(value)) {}
+
+        reference operator[](std::size_t i){
+            return reference(hot_values[i], cold_values[i]);
+        }
+
+        const_reference operator[](std::size_t i) const {
+            return const_reference(hot_values[i], cold_values[i]);
+        }
+
+        iterator begin(){
+            return iterator(this, 0);
+        }
+
+        iterator end(){
+            return iterator(this, size());
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size());
+        }
+
+        void push_back(const T& value){
+            hot_values.push_back(traits::hot(value));
+            cold_values.push_back(traits::cold(value));
+        }
+
+        void pop_back(){
+            hot_values.pop_back();
+            cold_values.pop_back();
+        }
+
+        std::size_t size() const {
+            return hot_values.size();
+        }
+
+        bool empty() const {
+            return hot_values.empty();
+        }
+
+        void reserve(std::size_t size){
+            hot_values.reserve(size);
+            cold_values.reserve(size);
+        }
+
+        void clear(){
+            hot_values.clear();
+            cold_values.clear();
+        }
+
+        // direct access to the arrays
+
+        std::vector<hot_type>& hot(){
+            return hot_values;
+        }
+
+        std::vector<cold_type>& cold(){
+            return cold_values;
+        }
+
+    private:
+        std::vector<hot_type> hot_values;
+        std::vector<cold_type> cold_values;
+};
+
+} //end of namespace containers
+
+#endif
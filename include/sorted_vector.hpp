@@ -0,0 +1,144 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef ARTICLES_SORTED_VECTOR
+#define ARTICLES_SORTED_VECTOR
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace containers {
+
+// Sorted sequence (duplicates allowed) in a vector, with batched insertions.
+//
+// The inserted elements go to a pending buffer. When the buffer reaches
+// 1/8 of the sorted elements (at least min_buffer), it is sorted and
+// merged into them in one linear pass, so an insertion costs
+// a constant number of moves amortized instead of a shift of half the
+// vector. The lookups search both the sorted elements and the buffer, the
+// iteration merges the buffer first. The buffer is kept sorted
+// incrementally: a lookup only sorts the elements inserted since the
+// previous one and merges them into the sorted part of the buffer.
+
+template<typename T, typename Compare = std::less<T>>
+class sorted_vector {
+    public:
+        static const std::size_t min_buffer = 64;
+        static const std::size_t buffer_ratio = 8;
+
+        typedef T value_type;
+        typedef typename std::vector<T>::const_iterator iterator;
+        typedef iterator const_iterator;
+
+        explicit sorted_vector(Compare compare = Compare()) : compare(compare) {}
+
+        void insert(const T& value){
+            buffer.push_back(value);
+
+            if(buffer.size() >= std::max(min_buffer, values.size() / buffer_ratio)){
+                flush();
+            }
+        }
+
+        // number of elements equivalent to value, sorted or pending
+        std::size_t count(const T& value) const {
+            sort_buffer();
+
+            auto in_values = std::equal_range(values.begin(), values.end(), value, compare);
+            auto in_buffer = std::equal_range(buffer.begin(), buffer.end(), value, compare);
+
+            return (in_values.second - in_values.first) + (in_buffer.second - in_buffer.first);
+        }
+
+        bool contains(const T& value) const {
+            sort_buffer();
+
+            return std::binary_search(values.begin(), values.end(), value, compare)
+                || std::binary_search(buffer.begin(), buffer.end(), value, compare);
+        }
+
+        // merge the pending elements into the sorted ones
+        void flush() const {
+            if(buffer.empty()){
+                return;
+            }
+
+            sort_buffer();
+
+            // each element is moved only once, the equivalent pending
+            // elements go after the sorted ones
+            std::vector<T> merged;
+            merged.reserve(std::max(values.capacity(), values.size() + buffer.size()));
+
+            std::merge(
+                std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()),
+                std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()),
+                std::back_inserter(merged), compare);
+
+            values.swap(merged);
+            buffer.clear();
+            sorted_prefix = 0;
+        }
+
+        iterator begin() const {
+            flush();
+            return values.begin();
+        }
+
+        iterator end() const {
+            flush();
+            return values.end();
+        }
+
+        std::size_t size() const {
+            return values.size() + buffer.size();
+        }
+
+        bool empty() const {
+            return values.empty() && buffer.empty();
+        }
+
+        void reserve(std::size_t size){
+            values.reserve(size);
+        }
+
+        void clear(){
+            values.clear();
+            buffer.clear();
+            sorted_prefix = 0;
+        }
+
+    private:
+        // the buffer is merged or sorted lazily by the const functions
+        mutable std::vector<T> values;
+        mutable std::vector<T> buffer;
+        mutable std::size_t sorted_prefix = 0;  // number of sorted elements at the front of the buffer
+        Compare compare;
+
+        void sort_buffer() const {
+            if(sorted_prefix != buffer.size()){
+                auto middle = buffer.begin() + sorted_prefix;
+
+                std::sort(middle, buffer.end(), compare);
+                std::inplace_merge(buffer.begin(), middle, buffer.end(), compare);
+
+                sorted_prefix = buffer.size();
+            }
+        }
+};
+
+template<typename T, typename Compare>
+const std::size_t sorted_vector<T, Compare>::min_buffer;
+
+template<typename T, typename Compare>
+const std::size_t sorted_vector<T, Compare>::buffer_ratio;
+
+} //end of namespace containers
+
+#endif
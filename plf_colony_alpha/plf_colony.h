@@ -192,6 +192,7 @@ private:
 
 
 	struct group; // forward declaration for typedefs below
+	struct sort_entry;
 
 	#ifdef PLF_COLONY_ALLOCATOR_TRAITS_SUPPORT // C++11
 		typedef typename std::allocator_traits<element_allocator_type>::template rebind_alloc<group>				group_allocator_type;
@@ -204,6 +205,7 @@ private:
 		typedef typename std::allocator_traits<uchar_allocator_type>::pointer				uchar_pointer_type;
 
 		typedef typename std::allocator_traits<element_allocator_type>::template rebind_alloc<element_pointer_type>	element_pointer_allocator_type;
+		typedef typename std::allocator_traits<element_allocator_type>::template rebind_alloc<sort_entry>				sort_entry_allocator_type;
 	#else
 		typedef typename element_allocator_type::template rebind<group>::other				group_allocator_type;
 		typedef typename element_allocator_type::template rebind<skipfield_type>::other		skipfield_allocator_type;
@@ -215,6 +217,7 @@ private:
 		typedef typename uchar_allocator_type::pointer				uchar_pointer_type;
 
 		typedef typename element_allocator_type::template rebind<element_pointer_type>::other element_pointer_allocator_type;
+		typedef typename element_allocator_type::template rebind<sort_entry>::other sort_entry_allocator_type;
 	#endif
 
 
@@ -2040,7 +2043,7 @@ public:
 
 private:
 
-	// Internal functions for insert-fill:
+	// Internal functions for insert-fill and range-insert:
 	void group_create(const skipfield_type number_of_elements)
 	{
 		const group_pointer_type next_group = end_iterator.group_pointer->next_group = PLF_COLONY_ALLOCATE(group_allocator_type, group_allocator_pair, 1, end_iterator.group_pointer);
@@ -2055,40 +2058,188 @@ private:
 		}
 		catch (...)
 		{
-			PLF_COLONY_DESTROY(group_allocator_type, group_allocator_pair, next_group);
 			PLF_COLONY_DEALLOCATE(group_allocator_type, group_allocator_pair, next_group, 1);
 			end_iterator.group_pointer->next_group = NULL;
 			throw;
 		}
 
+		next_group->number_of_elements = 0; // The group constructor counts the element inserted along with it in insert(), the group_fill functions count their own elements
 		end_iterator.group_pointer = next_group;
 		end_iterator.element_pointer = next_group->elements;
+		end_iterator.skipfield_pointer = next_group->skipfield;
 	}
 
 
 
+	// Updates the final group, end_iterator and the size after number_of_elements have been constructed from end_iterator.element_pointer onwards:
+	void group_fill_end(const element_pointer_type fill_end, const skipfield_type number_of_elements)
+	{
+		end_iterator.group_pointer->last_endpoint = end_iterator.element_pointer = fill_end;
+		end_iterator.skipfield_pointer = end_iterator.group_pointer->skipfield + (fill_end - end_iterator.group_pointer->elements);
+		end_iterator.group_pointer->number_of_elements += number_of_elements;
+		total_number_of_elements += number_of_elements;
+	}
+
+
+
+	// Constructs number_of_elements copies of element in the free space at the end of the final group:
 	void group_fill(const element_type &element, const skipfield_type number_of_elements)
 	{
-		const element_pointer_type fill_end = end_iterator.element_pointer + number_of_elements;
+		const element_pointer_type fill_start = end_iterator.element_pointer;
 
-		do
+		#ifdef PLF_COLONY_TYPE_TRAITS_SUPPORT
+			if (std::is_trivially_copyable<element_type>::value) // Cannot throw, copy the element directly instead of constructing each copy through the allocator
+			{
+				std::uninitialized_fill_n(&*fill_start, number_of_elements, element);
+				group_fill_end(fill_start + number_of_elements, number_of_elements);
+				return;
+			}
+		#endif
+
+		const element_pointer_type fill_end = fill_start + number_of_elements;
+		element_pointer_type current_location = fill_start;
+
+		try
 		{
-			try
+			for (; current_location != fill_end; ++current_location)
 			{
-				PLF_COLONY_CONSTRUCT(element_allocator_type, (*this), end_iterator.element_pointer++, element);
+				PLF_COLONY_CONSTRUCT(element_allocator_type, (*this), current_location, element);
 			}
-			catch (...)
+		}
+		catch (...)
+		{
+			group_fill_end(current_location, static_cast<skipfield_type>(current_location - fill_start));
+			throw;
+		}
+
+		group_fill_end(fill_end, number_of_elements);
+	}
+
+
+
+	// Constructs number_of_elements elements from the range starting at current in the free space at the end of the final group, current is advanced past the elements used:
+	template <class iterator_type>
+	void group_fill_range(iterator_type &current, const skipfield_type number_of_elements)
+	{
+		const element_pointer_type fill_start = end_iterator.element_pointer;
+
+		#ifdef PLF_COLONY_TYPE_TRAITS_SUPPORT
+			if (std::is_trivially_copyable<element_type>::value) // Cannot throw, a single std::uninitialized_copy which becomes a memmove for contiguous sources of element_type
 			{
-				end_iterator.group_pointer->last_endpoint = --end_iterator.element_pointer;
-				const skipfield_type temp = static_cast<const skipfield_type>(end_iterator.element_pointer - end_iterator.group_pointer->elements);
-				end_iterator.group_pointer->number_of_elements = temp;
-				end_iterator.skipfield_pointer = end_iterator.group_pointer->skipfield + temp;
-				throw;
+				iterator_type range_end = current;
+				std::advance(range_end, number_of_elements);
+				std::uninitialized_copy(current, range_end, &*fill_start);
+				current = range_end;
+				group_fill_end(fill_start + number_of_elements, number_of_elements);
+				return;
 			}
-		} while (end_iterator.element_pointer != fill_end);
+		#endif
+
+		const element_pointer_type fill_end = fill_start + number_of_elements;
+		element_pointer_type current_location = fill_start;
 
-		end_iterator.group_pointer->last_endpoint = end_iterator.element_pointer;
-		end_iterator.group_pointer->number_of_elements = number_of_elements;
+		try
+		{
+			for (; current_location != fill_end; ++current_location, ++current)
+			{
+				PLF_COLONY_CONSTRUCT(element_allocator_type, (*this), current_location, *current);
+			}
+		}
+		catch (...)
+		{
+			group_fill_end(current_location, static_cast<skipfield_type>(current_location - fill_start));
+			throw;
+		}
+
+		group_fill_end(fill_end, number_of_elements);
+	}
+
+
+
+	// Sources of elements for bulk_insert:
+	struct fill_source
+	{
+		const element_type &element;
+
+		explicit fill_source(const element_type &the_element):
+			element(the_element)
+		{}
+
+		void insert_next(colony &target)
+		{
+			target.insert(element);
+		}
+
+		void fill(colony &target, const skipfield_type number_of_elements)
+		{
+			target.group_fill(element, number_of_elements);
+		}
+	};
+
+
+
+	template <class iterator_type>
+	struct range_source
+	{
+		iterator_type current;
+
+		explicit range_source(const iterator_type &first):
+			current(first)
+		{}
+
+		void insert_next(colony &target)
+		{
+			target.insert(*current);
+			++current;
+		}
+
+		void fill(colony &target, const skipfield_type number_of_elements)
+		{
+			target.group_fill_range(current, number_of_elements);
+		}
+	};
+
+
+
+	// Inserts number_of_elements elements from source into a colony which has at least one group: the erased locations are reused first (one at a time, as they are scattered), then the free space at the end of the final group is filled in one go, then whole groups are created for the remainder, each sized for the remaining elements (within the group size limits) and filled in one go.
+	template <class source_type>
+	void bulk_insert(source_type &source, size_type number_of_elements)
+	{
+		while (number_of_elements != 0 && erased_locations.total_number_of_elements != 0)
+		{
+			source.insert_next(*this);
+			--number_of_elements;
+		}
+
+		const size_type space_available = static_cast<size_type>(reinterpret_cast<element_pointer_type>(end_iterator.group_pointer->skipfield) - end_iterator.element_pointer);
+
+		if (number_of_elements != 0 && space_available != 0)
+		{
+			const skipfield_type fill_amount = static_cast<skipfield_type>((number_of_elements < space_available) ? number_of_elements : space_available);
+			source.fill(*this, fill_amount);
+			number_of_elements -= fill_amount;
+		}
+
+		while (number_of_elements != 0)
+		{
+			// Grow geometrically like insert(), but with room for all the remaining elements if possible:
+			const size_type wanted_size = (number_of_elements > total_number_of_elements) ? number_of_elements : total_number_of_elements;
+			const skipfield_type new_group_size = (wanted_size < static_cast<size_type>(group_allocator_pair.max_elements_per_group)) ? static_cast<skipfield_type>(wanted_size) : group_allocator_pair.max_elements_per_group;
+			const skipfield_type fill_amount = (number_of_elements < static_cast<size_type>(new_group_size)) ? static_cast<skipfield_type>(number_of_elements) : new_group_size;
+
+			group_create(new_group_size);
+			source.fill(*this, fill_amount);
+			number_of_elements -= fill_amount;
+		}
+	}
+
+
+
+	// First group of a colony about to receive number_of_elements elements at once:
+	void initialize_for_bulk_insert(const size_type number_of_elements)
+	{
+		initialize((number_of_elements < min_elements_per_group) ? min_elements_per_group : (number_of_elements > group_allocator_pair.max_elements_per_group) ? group_allocator_pair.max_elements_per_group : static_cast<skipfield_type>(number_of_elements));
+		first_group->number_of_elements = 0;
 	}
 
 
@@ -2104,85 +2255,93 @@ public:
 			return end_iterator;
 		}
 
+		fill_source source(element);
+
 		if (first_group == NULL) // Empty colony, no groups created yet
 		{
-			if (number_of_elements > group_allocator_pair.max_elements_per_group)
-			{
-				// Create and fill first group:
-				initialize(group_allocator_pair.max_elements_per_group); // Construct first group
-				group_fill(element, group_allocator_pair.max_elements_per_group);
+			initialize_for_bulk_insert(number_of_elements);
 
-				// Create and fill all remaining groups:
-				size_type multiples = (number_of_elements / static_cast<size_type>(group_allocator_pair.max_elements_per_group));
-				const skipfield_type element_remainder = static_cast<const skipfield_type>(number_of_elements - (multiples * static_cast<size_type>(group_allocator_pair.max_elements_per_group)));
-
-				while (--multiples != 0)
+			try
+			{
+				bulk_insert(source, number_of_elements);
+			}
+			catch (...)
+			{
+				if (total_number_of_elements == 0)
 				{
-					group_create(group_allocator_pair.max_elements_per_group);
-					group_fill(element, group_allocator_pair.max_elements_per_group);
+					clear();
 				}
 
-				if (element_remainder != 0)
-				{
-					group_create(group_allocator_pair.max_elements_per_group);
-					group_fill(element, element_remainder);
-				}
-			}
-			else
-			{
-				initialize((number_of_elements < min_elements_per_group) ? min_elements_per_group : static_cast<skipfield_type>(number_of_elements)); // Construct first group
-				group_fill(element, static_cast<skipfield_type>(number_of_elements));
+				throw;
 			}
 
-			end_iterator.skipfield_pointer = end_iterator.group_pointer->skipfield + end_iterator.group_pointer->number_of_elements;
-			total_number_of_elements += number_of_elements;
 			return begin_iterator;
 		}
-		else
+
+		const iterator return_iterator = insert(element);
+		bulk_insert(source, number_of_elements - 1);
+		return return_iterator;
+	}
+
+
+
+private:
+
+	template <class iterator_type>
+	iterator range_insert(const iterator_type first, const iterator_type last, std::input_iterator_tag)
+	{
+		const iterator return_iterator = insert(*first);
+		iterator_type current_element = first;
+
+		while (++current_element != last)
 		{
-			const iterator return_iterator = insert(element);
-			size_type num_elements = number_of_elements - 1;
-			size_type capacity_available = (reinterpret_cast<element_pointer_type>(end_iterator.group_pointer->skipfield) - end_iterator.element_pointer) + erased_locations.total_number_of_elements;
+			insert(*current_element);
+		}
+
+		return return_iterator;
+	}
+
 
-			// Use up erased locations and remainder of current group first:
-			while (capacity_available-- != 0 && num_elements-- != 0)
+
+	// With forward iterators, the number of elements is known beforehand and they can be inserted in bulk:
+	template <class iterator_type>
+	iterator range_insert(const iterator_type first, const iterator_type last, std::forward_iterator_tag)
+	{
+		const size_type number_of_elements = static_cast<size_type>(std::distance(first, last));
+
+		if (first_group == NULL) // Empty colony, no groups created yet
+		{
+			range_source<iterator_type> source(first);
+			initialize_for_bulk_insert(number_of_elements);
+
+			try
 			{
-				insert(element);
+				bulk_insert(source, number_of_elements);
 			}
-
-			// If still some left over, create new groups and fill:
-			if (num_elements > group_allocator_pair.max_elements_per_group)
+			catch (...)
 			{
-				size_type multiples = (num_elements / static_cast<size_type>(group_allocator_pair.max_elements_per_group));
-				const skipfield_type element_remainder = static_cast<const skipfield_type>(num_elements - (multiples * static_cast<size_type>(group_allocator_pair.max_elements_per_group)));
-
-				while (multiples-- != 0)
+				if (total_number_of_elements == 0)
 				{
-					group_create(group_allocator_pair.max_elements_per_group);
-					group_fill(element, group_allocator_pair.max_elements_per_group);
+					clear();
 				}
 
-				if (element_remainder != 0)
-				{
-					group_create(group_allocator_pair.max_elements_per_group);
-					group_fill(element, element_remainder);
-				}
-			}
-			else if (num_elements > total_number_of_elements)
-			{
-				group_create(static_cast<skipfield_type>(num_elements));
-				group_fill(element, static_cast<skipfield_type>(num_elements));
+				throw;
 			}
 
-			end_iterator.skipfield_pointer = end_iterator.group_pointer->skipfield + end_iterator.group_pointer->number_of_elements;
-			total_number_of_elements += num_elements; // Adds the remainder - the insert functions above will already have incremented total_number_of_elements
-
-			return return_iterator;
+			return begin_iterator;
 		}
+
+		const iterator return_iterator = insert(*first);
+		iterator_type second = first;
+		range_source<iterator_type> source(++second);
+		bulk_insert(source, number_of_elements - 1);
+		return return_iterator;
 	}
 
 
 
+public:
+
 	// Range insert
 
 	template <class iterator_type>
@@ -2193,15 +2352,7 @@ public:
 			return end_iterator;
 		}
 
-		const iterator return_iterator = insert(*first);
-		iterator_type current_element = first;
-
-		while (++current_element != last)
-		{
-			insert(*current_element);
-		}
-
-		return return_iterator;
+		return range_insert(first, last, typename std::iterator_traits<iterator_type>::iterator_category());
 	}
 
 
@@ -2467,6 +2618,191 @@ private:
 
 
 
+	// Erases the elements of one group for which predicate returns true. The skipfield is rebuilt left to right in the same pass: an erased block is opened at the first erased element (or the previously-erased block just before it is extended) and its start node is written once the block ends, the nodes after it (including those of any previously-erased block it joins) being numbered by their distance from the start.
+	template <class predicate_function>
+	void erase_if_in_group(const group_pointer_type the_group, predicate_function &predicate)
+	{
+		element_pointer_type current_element = the_group->elements;
+		const element_pointer_type end_element = the_group->last_endpoint;
+		skipfield_pointer_type current_skipfield = the_group->skipfield;
+		skipfield_pointer_type block_start = NULL; // Start node of the erased block being built, if any
+		skipfield_type number_of_erasures = 0;
+
+		try
+		{
+			while (current_element != end_element)
+			{
+				if (*current_skipfield != 0) // Previously-erased block, its start node holds its length
+				{
+					const skipfield_type block_length = *current_skipfield;
+
+					if (block_start != NULL) // Joins the block being built, renumber its nodes
+					{
+						const skipfield_pointer_type block_end = current_skipfield + block_length;
+						skipfield_type node_value = static_cast<skipfield_type>(current_skipfield - block_start);
+
+						for (skipfield_pointer_type current_node = current_skipfield; current_node != block_end; ++current_node)
+						{
+							*current_node = ++node_value;
+						}
+					}
+
+					current_element += block_length;
+					current_skipfield += block_length;
+				}
+				else if (predicate(*current_element))
+				{
+					#ifdef PLF_COLONY_TYPE_TRAITS_SUPPORT
+						if (!(std::is_trivially_destructible<element_type>::value))
+					#endif
+					{
+						PLF_COLONY_DESTROY(element_allocator_type, (*this), current_element);
+					}
+
+					if (block_start == NULL)
+					{
+						if (current_skipfield != the_group->skipfield && *(current_skipfield - 1) != 0) // Extends the previously-erased block ending just before, its end node holds its length
+						{
+							block_start = current_skipfield - *(current_skipfield - 1);
+							*current_skipfield = static_cast<skipfield_type>(*(current_skipfield - 1) + 1);
+						}
+						else
+						{
+							block_start = current_skipfield;
+						}
+					}
+					else
+					{
+						*current_skipfield = static_cast<skipfield_type>(current_skipfield - block_start + 1);
+					}
+
+					++number_of_erasures;
+					erased_locations.push(current_element);
+
+					++current_element;
+					++current_skipfield;
+				}
+				else
+				{
+					if (block_start != NULL)
+					{
+						*block_start = static_cast<skipfield_type>(current_skipfield - block_start);
+						block_start = NULL;
+					}
+
+					++current_element;
+					++current_skipfield;
+				}
+			}
+		}
+		catch (...)
+		{
+			if (block_start != NULL)
+			{
+				*block_start = static_cast<skipfield_type>(current_skipfield - block_start);
+			}
+
+			the_group->number_of_elements -= number_of_erasures;
+			total_number_of_elements -= number_of_erasures;
+			throw;
+		}
+
+		if (block_start != NULL)
+		{
+			*block_start = static_cast<skipfield_type>(current_skipfield - block_start);
+		}
+
+		the_group->number_of_elements -= number_of_erasures;
+		total_number_of_elements -= number_of_erasures;
+	}
+
+
+
+	// Unlinks and deallocates the_group if it has no element left. Group numbers, iterators and erased locations are left to update_after_erase_if.
+	bool release_if_empty(const group_pointer_type the_group)
+	{
+		if (the_group->number_of_elements != 0)
+		{
+			return false;
+		}
+
+		if (the_group->previous_group != NULL)
+		{
+			the_group->previous_group->next_group = the_group->next_group;
+		}
+		else
+		{
+			first_group = the_group->next_group;
+		}
+
+		if (the_group->next_group != NULL)
+		{
+			the_group->next_group->previous_group = the_group->previous_group;
+		}
+
+		PLF_COLONY_DESTROY(group_allocator_type, group_allocator_pair, the_group);
+		PLF_COLONY_DEALLOCATE(group_allocator_type, group_allocator_pair, the_group, 1);
+		return true;
+	}
+
+
+
+	void update_after_erase_if(const bool groups_released)
+	{
+		if (first_group == NULL) // ie. colony is now empty
+		{
+			clear();
+			return;
+		}
+
+		group_pointer_type last_group = first_group;
+
+		if (groups_released)
+		{
+			// Renumber the remaining groups and rebuild erased_locations without the locations of the released groups:
+			erased_locations.clear();
+			size_type group_number = 0;
+
+			for (group_pointer_type current_group = first_group; current_group != NULL; current_group = current_group->next_group)
+			{
+				current_group->group_number = group_number++;
+				last_group = current_group;
+
+				const skipfield_pointer_type end_skipfield = current_group->skipfield + (current_group->last_endpoint - current_group->elements);
+
+				for (skipfield_pointer_type current_skipfield = current_group->skipfield; current_skipfield != end_skipfield;)
+				{
+					if (*current_skipfield == 0)
+					{
+						++current_skipfield;
+						continue;
+					}
+
+					const skipfield_pointer_type block_end = current_skipfield + *current_skipfield;
+
+					for (; current_skipfield != block_end; ++current_skipfield)
+					{
+						erased_locations.push(current_group->elements + (current_skipfield - current_group->skipfield));
+					}
+				}
+			}
+		}
+		else
+		{
+			last_group = end_iterator.group_pointer;
+		}
+
+		begin_iterator.group_pointer = first_group;
+		begin_iterator.element_pointer = first_group->elements + *(first_group->skipfield);
+		begin_iterator.skipfield_pointer = first_group->skipfield + *(first_group->skipfield);
+
+		end_iterator.group_pointer = last_group;
+		end_iterator.element_pointer = last_group->last_endpoint;
+		end_iterator.skipfield_pointer = last_group->skipfield + (last_group->last_endpoint - last_group->elements);
+	}
+
+
+
 	inline PLF_COLONY_FORCE_INLINE void update_subsequent_group_numbers(group_pointer_type the_group) PLF_COLONY_NOEXCEPT
 	{
 		do
@@ -2913,6 +3249,41 @@ public:
 
 
 
+	// Erases every element for which predicate returns true and returns the number of erased elements. Unlike calling erase() on each element, each group is processed in a single pass: its skipfield blocks are rebuilt as the pass goes, the groups left empty are all released at the end, and the group numbers, iterators and erased locations are updated once for the whole colony.
+	template <class predicate_function>
+	size_type erase_if(predicate_function predicate)
+	{
+		if (total_number_of_elements == 0)
+		{
+			return 0;
+		}
+
+		const size_type original_size = total_number_of_elements;
+		bool groups_released = false;
+		group_pointer_type current_group = first_group, next_group;
+
+		try
+		{
+			for (; current_group != NULL; current_group = next_group)
+			{
+				next_group = current_group->next_group;
+				erase_if_in_group(current_group, predicate);
+				groups_released |= release_if_empty(current_group);
+			}
+		}
+		catch (...)
+		{
+			groups_released |= release_if_empty(current_group); // The group is left consistent by erase_if_in_group
+			update_after_erase_if(groups_released);
+			throw;
+		}
+
+		update_after_erase_if(groups_released);
+		return original_size - total_number_of_elements;
+	}
+
+
+
 	inline PLF_COLONY_FORCE_INLINE bool empty() const PLF_COLONY_NOEXCEPT
 	{
 		return total_number_of_elements == 0;
@@ -3927,6 +4298,148 @@ private:
 	};
 
 
+	// An element and its position in iteration order, sorted by sort_in_place
+	struct sort_entry
+	{
+		element_pointer_type element;
+		size_type index;
+	};
+
+
+	template <class comparison_function>
+	struct sort_entry_dereferencer
+	{
+		comparison_function stored_instance;
+
+		sort_entry_dereferencer(const comparison_function &function_instance):
+			stored_instance(function_instance)
+		{}
+
+		bool operator() (const sort_entry &first, const sort_entry &second) const
+		{
+			return stored_instance(*(first.element), *(second.element));
+		}
+	};
+
+
+	// The sort algorithms used by sort_in_place
+	struct std_sort_function
+	{
+		template <class iterator_type, class comparison_function>
+		void operator() (iterator_type first, iterator_type last, comparison_function compare) const
+		{
+			std::sort(first, last, compare);
+		}
+	};
+
+
+	struct timsort_function
+	{
+		template <class iterator_type, class comparison_function>
+		void operator() (iterator_type first, iterator_type last, comparison_function compare) const
+		{
+			plf::timsort(first, last, compare);
+		}
+	};
+
+
+	#if defined(PLF_COLONY_TYPE_TRAITS_SUPPORT) && defined(PLF_COLONY_MOVE_SEMANTICS_SUPPORT)
+		// Sorts the elements where they are: the elements are sorted by pointer along with their indexes in iteration order, then the resulting permutation is applied by following its cycles, moving each element once. Unlike the sort rebuilding the colony, no group is allocated, the skipfields and the erased locations are untouched, only the values of the occupied slots change. Used for types with non-throwing moves, so that an exception (from the comparison function) can only happen before any element is moved.
+		template <class comparison_function, class sort_function>
+		void sort_in_place(comparison_function compare, sort_function sorter)
+		{
+			sort_entry_allocator_type entry_allocator(*this);
+			sort_entry * const order = PLF_COLONY_ALLOCATE(sort_entry_allocator_type, entry_allocator, total_number_of_elements, NULL);
+
+			size_type index = 0;
+
+			for (iterator current_element = begin_iterator; current_element != end_iterator; ++current_element, ++index)
+			{
+				order[index].element = &*current_element;
+				order[index].index = index;
+			}
+
+			try
+			{
+				sorter(order, order + total_number_of_elements, sort_entry_dereferencer<comparison_function>(compare));
+			}
+			catch (...)
+			{
+				PLF_COLONY_DEALLOCATE(sort_entry_allocator_type, entry_allocator, order, total_number_of_elements);
+				throw;
+			}
+
+			// order[i].index is the index of the element going to the slot i and order[i].element its address, a slot is done once order[i].index == i. Each cycle starts by moving out the element going to the slot start, which leaves a hole at a known address: the hole is filled from order[current].element and moves there, until the hole reaches the slot start.
+			for (size_type start = 0; start != total_number_of_elements; ++start)
+			{
+				if (order[start].index == start)
+				{
+					continue;
+				}
+
+				element_type temp(std::move(*(order[start].element)));
+				element_pointer_type hole = order[start].element;
+				size_type current = order[start].index;
+				order[start].index = start;
+
+				while (current != start)
+				{
+					const size_type next = order[current].index;
+					const element_pointer_type source = order[current].element;
+					*hole = std::move(*source);
+					order[current].index = current;
+					hole = source;
+					current = next;
+				}
+
+				*hole = std::move(temp);
+			}
+
+			PLF_COLONY_DEALLOCATE(sort_entry_allocator_type, entry_allocator, order, total_number_of_elements);
+		}
+
+
+		// Sorts the elements in a contiguous buffer and moves them back into the same slots. For trivially copyable types no larger than a sort_entry, sorting the values directly is cheaper than dereferencing a pointer in every comparison, moving them in the buffer is as cheap as moving pointers, and the buffer is no larger than the sort entries used by sort_in_place. If the comparison function throws, the elements are moved back in their current order.
+		template <class comparison_function, class sort_function>
+		void sort_by_value(comparison_function compare, sort_function sorter)
+		{
+			const element_pointer_type values = PLF_COLONY_ALLOCATE(element_allocator_type, (*this), total_number_of_elements, NULL);
+			element_pointer_type current_value = values;
+
+			for (iterator current_element = begin_iterator; current_element != end_iterator; ++current_element, ++current_value)
+			{
+				PLF_COLONY_CONSTRUCT(element_allocator_type, (*this), current_value, std::move(*current_element));
+			}
+
+			try
+			{
+				sorter(values, values + total_number_of_elements, compare);
+			}
+			catch (...)
+			{
+				move_back_sorted_values(values);
+				throw;
+			}
+
+			move_back_sorted_values(values);
+		}
+
+
+		void move_back_sorted_values(const element_pointer_type values)
+		{
+			element_pointer_type current_value = values;
+
+			for (iterator current_element = begin_iterator; current_element != end_iterator; ++current_element, ++current_value)
+			{
+				*current_element = std::move(*current_value);
+				PLF_COLONY_DESTROY(element_allocator_type, (*this), current_value);
+			}
+
+			PLF_COLONY_DEALLOCATE(element_allocator_type, (*this), values, total_number_of_elements);
+		}
+	#endif
+
+
 public:
 
 	inline void sort()
@@ -3942,6 +4455,22 @@ public:
 			return;
 		}
 
+		#if defined(PLF_COLONY_TYPE_TRAITS_SUPPORT) && defined(PLF_COLONY_MOVE_SEMANTICS_SUPPORT)
+			if (std::is_nothrow_move_constructible<element_type>::value && std::is_nothrow_move_assignable<element_type>::value)
+			{
+				if (std::is_trivially_copyable<element_type>::value && sizeof(element_type) <= sizeof(sort_entry)) // Small enough to be sorted by value without using more memory than sort_in_place, see sort_by_value
+				{
+					sort_by_value(compare, std_sort_function());
+				}
+				else
+				{
+					sort_in_place(compare, std_sort_function());
+				}
+
+				return;
+			}
+		#endif
+
 		element_pointer_type * const element_pointers = PLF_COLONY_ALLOCATE(element_pointer_allocator_type, erased_locations, total_number_of_elements, NULL);
 		element_pointer_type *element_pointer = element_pointers;
 
@@ -4026,6 +4555,22 @@ public:
 			return;
 		}
 
+		#if defined(PLF_COLONY_TYPE_TRAITS_SUPPORT) && defined(PLF_COLONY_MOVE_SEMANTICS_SUPPORT)
+			if (std::is_nothrow_move_constructible<element_type>::value && std::is_nothrow_move_assignable<element_type>::value)
+			{
+				if (std::is_trivially_copyable<element_type>::value && sizeof(element_type) <= sizeof(sort_entry)) // Small enough to be sorted by value without using more memory than sort_in_place, see sort_by_value
+				{
+					sort_by_value(compare, timsort_function());
+				}
+				else
+				{
+					sort_in_place(compare, timsort_function());
+				}
+
+				return;
+			}
+		#endif
+
 		element_pointer_type * const element_pointers = PLF_COLONY_ALLOCATE(element_pointer_allocator_type, erased_locations, total_number_of_elements, NULL);
 		element_pointer_type *element_pointer = element_pointers;
 
@@ -4098,6 +4643,159 @@ public:
 	}
 
 
+
+	// A group of the colony as a contiguous span: its elements array and skipfield up to the last used cell, and its number of non-erased elements. The segments do not share any element, so they can be processed concurrently.
+	struct segment
+	{
+		element_pointer_type elements;
+		skipfield_pointer_type skipfield;
+		size_type size; // Number of cells, erased ones included
+		size_type count; // Number of non-erased elements
+
+		// Calls function on the non-erased elements of the segment, in order. A segment without erasures is a straight pointer loop (vectorizable), otherwise the elements are processed in runs of consecutive elements, the erased blocks in between being skipped in one jump via the skipfield.
+		template <class function_type>
+		void for_each(function_type &function) const
+		{
+			element_pointer_type current_element = elements;
+			const element_pointer_type end_element = elements + size;
+
+			if (count == size) // No erasures in this segment
+			{
+				for (; current_element != end_element; ++current_element)
+				{
+					function(*current_element);
+				}
+			}
+			else
+			{
+				skipfield_pointer_type current_skipfield = skipfield;
+
+				while (current_element != end_element)
+				{
+					// The first node of an erased block holds the length of the block, 0 for a non-erased element
+					const skipfield_type skip = *current_skipfield;
+					current_element += skip;
+					current_skipfield += skip;
+
+					for (; current_element != end_element && *current_skipfield == 0; ++current_element, ++current_skipfield)
+					{
+						function(*current_element);
+					}
+				}
+			}
+		}
+
+
+		// Returns a pointer to the first non-erased element of the segment for which predicate returns true, or NULL if there is none. The erased blocks are skipped as in for_each.
+		template <class predicate_function>
+		element_pointer_type find_if(predicate_function &predicate) const
+		{
+			element_pointer_type current_element = elements;
+			const element_pointer_type end_element = elements + size;
+
+			if (count == size) // No erasures in this segment
+			{
+				for (; current_element != end_element; ++current_element)
+				{
+					if (predicate(*current_element))
+					{
+						return current_element;
+					}
+				}
+			}
+			else
+			{
+				skipfield_pointer_type current_skipfield = skipfield;
+
+				while (current_element != end_element)
+				{
+					const skipfield_type skip = *current_skipfield;
+					current_element += skip;
+					current_skipfield += skip;
+
+					for (; current_element != end_element && *current_skipfield == 0; ++current_element, ++current_skipfield)
+					{
+						if (predicate(*current_element))
+						{
+							return current_element;
+						}
+					}
+				}
+			}
+
+			return NULL;
+		}
+	};
+
+
+
+	// Calls function on every segment (group) of the colony, in iteration order
+	template <class function_type>
+	void for_each_segment(function_type function)
+	{
+		if (total_number_of_elements == 0)
+		{
+			return;
+		}
+
+		for (group_pointer_type current_group = begin_iterator.group_pointer; current_group != NULL; current_group = current_group->next_group)
+		{
+			function(make_segment(current_group));
+		}
+	}
+
+
+
+	// Calls function on every element, in iteration order, a segment at a time. Unlike iterating with ++, which checks the skipfield and the end of the group at every element, this walks each group's elements array directly (see segment::for_each).
+	template <class function_type>
+	void for_each(function_type function)
+	{
+		if (total_number_of_elements == 0)
+		{
+			return;
+		}
+
+		for (group_pointer_type current_group = begin_iterator.group_pointer; current_group != NULL; current_group = current_group->next_group)
+		{
+			make_segment(current_group).for_each(function);
+		}
+	}
+
+
+
+	// Returns an iterator to the first element, in iteration order, for which predicate returns true, or end() if there is none. Walks the groups like for_each, but stops at the first match.
+	template <class predicate_function>
+	iterator find_if(predicate_function predicate)
+	{
+		if (total_number_of_elements == 0)
+		{
+			return end_iterator;
+		}
+
+		for (group_pointer_type current_group = begin_iterator.group_pointer; current_group != NULL; current_group = current_group->next_group)
+		{
+			const element_pointer_type found_element = make_segment(current_group).find_if(predicate);
+
+			if (found_element != NULL)
+			{
+				return iterator(current_group, found_element, current_group->skipfield + (found_element - current_group->elements));
+			}
+		}
+
+		return end_iterator;
+	}
+
+
+
+private:
+
+	static segment make_segment(const group_pointer_type the_group)
+	{
+		const segment the_segment = {the_group->elements, the_group->skipfield, static_cast<size_type>(the_group->last_endpoint - the_group->elements), static_cast<size_type>(the_group->number_of_elements)};
+		return the_segment;
+	}
+
+
 };	// colony
 
 
@@ -0,0 +1,178 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "allocations.hpp"
+
+namespace {
+
+std::atomic<bool> configured(false);
+std::atomic<bool> tracking(false);
+
+// updated by every thread that allocates while tracking (the worker
+// threads of a parallel benchmark, or freeing their own state)
+std::atomic<std::size_t> count(0);
+std::atomic<std::size_t> bytes(0);
+std::atomic<std::size_t> live(0);
+std::atomic<std::size_t> peak(0);
+std::atomic<std::chrono::steady_clock::rep> elapsed(0);
+
+void add_elapsed(std::chrono::steady_clock::time_point t0){
+    elapsed.fetch_add((std::chrono::steady_clock::now() - t0).count(), std::memory_order_relaxed);
+}
+
+void add_live(std::size_t size){
+    auto current = live.fetch_add(size, std::memory_order_relaxed) + size;
+    auto highest = peak.load(std::memory_order_relaxed);
+
+    while(highest < current && !peak.compare_exchange_weak(highest, current, std::memory_order_relaxed)){}
+}
+
+// blocks allocated before the tracking started are not accounted
+void remove_live(std::size_t size){
+    auto current = live.load(std::memory_order_relaxed);
+
+    while(!live.compare_exchange_weak(current, current > size ? current - size : 0, std::memory_order_relaxed)){}
+}
+
+//Size of the block really used, to know the live bytes when it is freed
+std::size_t block_size(void* p){
+#ifdef __GLIBC__
+    return malloc_usable_size(p);
+#else
+    (void) p;
+    return 0;
+#endif
+}
+
+void* allocate(std::size_t size){
+    if(!tracking.load(std::memory_order_relaxed)){
+        return std::malloc(size ? size : 1);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    void* p = std::malloc(size ? size : 1);
+    add_elapsed(t0);
+
+    if(p){
+        count.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        add_live(block_size(p));
+    }
+
+    return p;
+}
+
+void deallocate(void* p){
+    if(!p){
+        return;
+    }
+
+    if(!tracking.load(std::memory_order_relaxed)){
+        std::free(p);
+        return;
+    }
+
+    remove_live(block_size(p));
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::free(p);
+    add_elapsed(t0);
+}
+
+void* allocate_or_throw(std::size_t size){
+    void* p = allocate(size);
+
+    while(!p){
+        auto handler = std::get_new_handler();
+
+        if(!handler){
+            throw std::bad_alloc();
+        }
+
+        handler();
+        p = allocate(size);
+    }
+
+    return p;
+}
+
+} //end of anonymous namespace
+
+void allocations::enable(bool enabled){
+    configured.store(enabled);
+}
+
+bool allocations::enabled(){
+    return configured.load();
+}
+
+void allocations::start(){
+    count.store(0);
+    bytes.store(0);
+    live.store(0);
+    peak.store(0);
+    elapsed.store(0);
+
+    tracking.store(enabled());
+}
+
+graphs::allocations allocations::stop(){
+    tracking.store(false);
+
+    if(!enabled()){
+        return graphs::unavailable_allocations();
+    }
+
+    return {
+        static_cast<double>(count.load()),
+        static_cast<double>(bytes.load()),
+        static_cast<double>(peak.load()),
+        std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(std::chrono::steady_clock::duration(elapsed.load())).count()};
+}
+
+// replacements of the global allocation functions
+
+void* operator new(std::size_t size){
+    return allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size){
+    return allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
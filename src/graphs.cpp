@@ -7,8 +7,12 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <unordered_map>
 #include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <cmath>
 
 #include "graphs.hpp"
 
@@ -22,10 +26,40 @@ void graphs::new_graph(const std::string& graph_name, const std::string& graph_t
     std::cout << "Start " << graph_name << std::endl;
 }
 
-void graphs::new_result(const std::string& serie, const std::string& group, std::size_t value){
-    current_graph->results.push_back({serie, group, value});
+graphs::counters graphs::unavailable_counters(){
+    return {-1.0, -1.0, -1.0, -1.0, -1.0};
+}
+
+graphs::allocations graphs::unavailable_allocations(){
+    return {-1.0, -1.0, -1.0, -1.0};
+}
 
-    std::cout << serie << ":" << group << ":" << value << std::endl;
+bool has_counters(const graphs::counters& hw){
+    return hw.cycles >= 0.0 || hw.instructions >= 0.0 || hw.cache_misses >= 0.0 || hw.branch_misses >= 0.0 || hw.dtlb_misses >= 0.0;
+}
+
+void graphs::new_result(const std::string& serie, const std::string& group, std::size_t value, const statistics& stats, const counters& hw,
+        const std::vector<double>& samples, const allocations& heap){
+    current_graph->results.push_back({serie, group, value, stats, hw, samples, heap});
+
+    std::cout << serie << ":" << group << ":" << value;
+
+    if(stats.iterations){
+        std::cout << " (min=" << stats.min << "ns median=" << stats.median << "ns mean=" << stats.mean
+            << "ns p90=" << stats.p90 << "ns stddev=" << stats.stddev << "ns iterations=" << stats.iterations << ")";
+    }
+
+    if(has_counters(hw)){
+        std::cout << " (cycles=" << hw.cycles << " instructions=" << hw.instructions << " cache_misses=" << hw.cache_misses
+            << " branch_misses=" << hw.branch_misses << " dtlb_misses=" << hw.dtlb_misses << ")";
+    }
+
+    if(heap.count >= 0.0){
+        std::cout << " (allocations=" << heap.count << " bytes=" << heap.bytes << " peak_bytes=" << heap.peak_bytes
+            << " allocator_time=" << heap.time << "ns)";
+    }
+
+    std::cout << std::endl;
 }
 
 std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>> compute_values(std::shared_ptr<graphs::graph> graph){
@@ -42,7 +76,350 @@ bool numeric_cmp(const std::string& lhs, const std::string& rhs){
     return atoi(lhs.c_str()) < atoi(rhs.c_str());
 }
 
+//Series in order of first appearance
+std::vector<std::string> compute_series(std::shared_ptr<graphs::graph> graph){
+    std::vector<std::string> series;
+
+    for(auto& result : graph->results){
+        if(std::find(series.begin(), series.end(), result.serie) == series.end()){
+            series.push_back(result.serie);
+        }
+    }
+
+    return series;
+}
+
+//Groups in numeric order
+std::vector<std::string> compute_groups(std::shared_ptr<graphs::graph> graph){
+    std::vector<std::string> groups;
+
+    for(auto& result : graph->results){
+        if(std::find(groups.begin(), groups.end(), result.group) == groups.end()){
+            groups.push_back(result.group);
+        }
+    }
+
+    std::stable_sort(groups.begin(), groups.end(), numeric_cmp);
+
+    return groups;
+}
+
+//Results ordered by serie and then by group
+std::vector<graphs::result> sorted_results(std::shared_ptr<graphs::graph> graph){
+    auto series = compute_series(graph);
+    auto groups = compute_groups(graph);
+
+    auto index = [](const std::vector<std::string>& v, const std::string& value){
+        return std::find(v.begin(), v.end(), value) - v.begin();
+    };
+
+    std::vector<graphs::result> results(graph->results);
+    std::stable_sort(results.begin(), results.end(), [&](const graphs::result& lhs, const graphs::result& rhs){
+        auto l = index(series, lhs.serie);
+        auto r = index(series, rhs.serie);
+        return l < r || (l == r && index(groups, lhs.group) < index(groups, rhs.group));
+    });
+
+    return results;
+}
+
+//['x', 'Cats', 'Blanket 1', 'Blanket 2'],
+void write_data(std::ofstream& file, std::shared_ptr<graphs::graph> graph){
+    auto results = compute_values(graph);
+    auto series = compute_series(graph);
+
+    file << "['x'";
+
+    for(auto& serie : series){
+        file << ", '" << serie << "'";
+    }
+
+    file << "]," << std::endl;
+
+    for(auto& group_title : compute_groups(graph)){
+        file << "['" << group_title << "'";
+
+        auto& values = results[group_title];
+
+        for(auto& serie : series){
+            auto it = values.find(serie);
+
+            if(it == values.end()){
+                file << ", null";
+            } else {
+                file << ", " << it->second;
+            }
+        }
+
+        file << "]," << std::endl;
+    }
+}
+
+void write_counter(std::ofstream& file, double value){
+    file << "<td>";
+
+    if(value >= 0.0){
+        file << static_cast<std::size_t>(value);
+    } else {
+        file << "-";
+    }
+
+    file << "</td>";
+}
+
+//Table of the hardware counters of the graph, if any has been measured
+void write_counters(std::ofstream& file, std::shared_ptr<graphs::graph> graph){
+    if(std::none_of(graph->results.begin(), graph->results.end(), [](const graphs::result& r){ return has_counters(r.hw); })){
+        return;
+    }
+
+    file << "<table>" << std::endl;
+    file << "<tr><th>Serie</th><th>Elements</th><th>Cycles</th><th>Instructions</th><th>IPC</th>"
+         << "<th>Cache misses</th><th>Branch misses</th><th>dTLB misses</th></tr>" << std::endl;
+
+    for(auto& result : graph->results){
+        file << "<tr><td>" << result.serie << "</td><td>" << result.group << "</td>";
+
+        write_counter(file, result.hw.cycles);
+        write_counter(file, result.hw.instructions);
+
+        if(result.hw.cycles > 0.0 && result.hw.instructions >= 0.0){
+            file << "<td>" << result.hw.instructions / result.hw.cycles << "</td>";
+        } else {
+            file << "<td>-</td>";
+        }
+
+        write_counter(file, result.hw.cache_misses);
+        write_counter(file, result.hw.branch_misses);
+        write_counter(file, result.hw.dtlb_misses);
+
+        file << "</tr>" << std::endl;
+    }
+
+    file << "</table>" << std::endl;
+}
+
+//Description of the run for the machine-readable outputs
+
+std::string timestamp(){
+    char buffer[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+std::string cpu_model(){
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+
+    while(std::getline(cpuinfo, line)){
+        if(line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos){
+            return line.substr(line.find(':') + 2);
+        }
+    }
+
+    return "unknown";
+}
+
+std::string compiler(){
+#ifdef __VERSION__
+#ifdef __clang__
+    return "clang " __VERSION__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return __VERSION__;
+#endif
+#else
+    return "unknown";
+#endif
+}
+
+//The exact command line is not known, only what the compiler exposes
+std::string compiler_flags(){
+    std::string flags;
+
+#ifdef BENCH_CXX_FLAGS
+    flags += BENCH_CXX_FLAGS " ";
+#endif
+#ifdef __OPTIMIZE__
+    flags += "-O ";
+#endif
+#ifdef NDEBUG
+    flags += "-DNDEBUG ";
+#endif
+#ifdef __AVX2__
+    flags += "-mavx2 ";
+#endif
+#ifdef __SSE4_2__
+    flags += "-msse4.2 ";
+#endif
+#ifdef _LIBCPP_VERSION
+    flags += "-stdlib=libc++ ";
+#endif
+
+    flags += "-std=c++" + std::to_string(__cplusplus / 100 % 100);
+
+    return flags;
+}
+
+std::string json_string(const std::string& value){
+    std::string escaped = "\"";
+
+    for(auto c : value){
+        if(c == '"' || c == '\\'){
+            escaped += '\\';
+            escaped += c;
+        } else if(static_cast<unsigned char>(c) < 0x20){
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            escaped += buffer;
+        } else {
+            escaped += c;
+        }
+    }
+
+    return escaped + "\"";
+}
+
+std::string csv_string(const std::string& value){
+    std::string escaped = "\"";
+
+    for(auto c : value){
+        if(c == '"'){
+            escaped += '"';
+        }
+
+        escaped += c;
+    }
+
+    return escaped + "\"";
+}
+
+//Unavailable counters are null in JSON and empty in CSV
+std::string counter_value(double value, const std::string& missing){
+    if(value < 0.0){
+        return missing;
+    }
+
+    std::ostringstream stream;
+    stream.precision(17);
+    stream << value;
+    return stream.str();
+}
+
+void write_json(std::ofstream& file, const std::vector<std::shared_ptr<graphs::graph>>& graphs){
+    file.precision(17);
+
+    file << "{" << std::endl;
+    file << "  \"timestamp\": " << json_string(timestamp()) << "," << std::endl;
+    file << "  \"cpu\": " << json_string(cpu_model()) << "," << std::endl;
+    file << "  \"compiler\": " << json_string(compiler()) << "," << std::endl;
+    file << "  \"flags\": " << json_string(compiler_flags()) << "," << std::endl;
+    file << "  \"graphs\": [";
+
+    for(std::size_t g = 0; g < graphs.size(); ++g){
+        auto& graph = graphs[g];
+
+        file << (g ? "," : "") << std::endl;
+        file << "    {" << std::endl;
+        file << "      \"name\": " << json_string(graph->name) << "," << std::endl;
+        file << "      \"title\": " << json_string(graph->title) << "," << std::endl;
+        file << "      \"unit\": " << json_string(graph->unit) << "," << std::endl;
+        file << "      \"results\": [";
+
+        auto results = sorted_results(graph);
+
+        for(std::size_t r = 0; r < results.size(); ++r){
+            auto& result = results[r];
+
+            file << (r ? "," : "") << std::endl;
+            file << "        {\"serie\": " << json_string(result.serie)
+                 << ", \"group\": " << json_string(result.group)
+                 << ", \"value\": " << result.value
+                 << ", \"iterations\": " << result.stats.iterations
+                 << ", \"min_ns\": " << result.stats.min
+                 << ", \"median_ns\": " << result.stats.median
+                 << ", \"mean_ns\": " << result.stats.mean
+                 << ", \"p90_ns\": " << result.stats.p90
+                 << ", \"stddev_ns\": " << result.stats.stddev
+                 << ", \"cycles\": " << counter_value(result.hw.cycles, "null")
+                 << ", \"instructions\": " << counter_value(result.hw.instructions, "null")
+                 << ", \"cache_misses\": " << counter_value(result.hw.cache_misses, "null")
+                 << ", \"branch_misses\": " << counter_value(result.hw.branch_misses, "null")
+                 << ", \"dtlb_misses\": " << counter_value(result.hw.dtlb_misses, "null")
+                 << ", \"allocations\": " << counter_value(result.heap.count, "null")
+                 << ", \"allocated_bytes\": " << counter_value(result.heap.bytes, "null")
+                 << ", \"peak_bytes\": " << counter_value(result.heap.peak_bytes, "null")
+                 << ", \"allocator_ns\": " << counter_value(result.heap.time, "null")
+                 << ", \"samples_ns\": [";
+
+            for(std::size_t i = 0; i < result.samples.size(); ++i){
+                file << (i ? ", " : "") << result.samples[i];
+            }
+
+            file << "]}";
+        }
+
+        file << std::endl << "      ]" << std::endl;
+        file << "    }";
+    }
+
+    file << std::endl << "  ]" << std::endl;
+    file << "}" << std::endl;
+}
+
+void write_csv(std::ofstream& file, const std::vector<std::shared_ptr<graphs::graph>>& graphs){
+    file.precision(17);
+
+    const std::string run = csv_string(timestamp()) + "," + csv_string(cpu_model()) + "," + csv_string(compiler()) + "," + csv_string(compiler_flags());
+
+    file << "graph,title,unit,serie,group,value,iterations,min_ns,median_ns,mean_ns,p90_ns,stddev_ns,"
+         << "cycles,instructions,cache_misses,branch_misses,dtlb_misses,allocations,allocated_bytes,peak_bytes,allocator_ns,"
+         << "samples_ns,timestamp,cpu,compiler,flags" << std::endl;
+
+    for(auto& graph : graphs){
+        for(auto& result : sorted_results(graph)){
+            file << csv_string(graph->name) << "," << csv_string(graph->title) << "," << csv_string(graph->unit) << ","
+                 << csv_string(result.serie) << "," << csv_string(result.group) << ","
+                 << result.value << "," << result.stats.iterations << ","
+                 << result.stats.min << "," << result.stats.median << "," << result.stats.mean << ","
+                 << result.stats.p90 << "," << result.stats.stddev << ","
+                 << counter_value(result.hw.cycles, "") << ","
+                 << counter_value(result.hw.instructions, "") << ","
+                 << counter_value(result.hw.cache_misses, "") << ","
+                 << counter_value(result.hw.branch_misses, "") << ","
+                 << counter_value(result.hw.dtlb_misses, "") << ","
+                 << counter_value(result.heap.count, "") << ","
+                 << counter_value(result.heap.bytes, "") << ","
+                 << counter_value(result.heap.peak_bytes, "") << ","
+                 << counter_value(result.heap.time, "") << ",";
+
+            //Space separated samples
+            file << "\"";
+            for(std::size_t i = 0; i < result.samples.size(); ++i){
+                file << (i ? " " : "") << result.samples[i];
+            }
+            file << "\",";
+
+            file << run << std::endl;
+        }
+    }
+}
+
 void graphs::output(Output output){
+    if(output == Output::JSON){
+        std::ofstream file("graph.json");
+        write_json(file, all_graphs);
+        return;
+    }
+
+    if(output == Output::CSV){
+        std::ofstream file("graph.csv");
+        write_csv(file, all_graphs);
+        return;
+    }
+
     if(output == Output::GOOGLE){
         std::ofstream file("graph.html");
 
@@ -61,35 +438,7 @@ void graphs::output(Output output){
 
             file << "var data = google.visualization.arrayToDataTable([" << std::endl;
 
-            //['x', 'Cats', 'Blanket 1', 'Blanket 2'],
-            auto results = compute_values(graph);
-
-            file << "['x'";
-
-            auto first = results.begin()->second;
-            for(auto& pair : first){
-                file << ", '" << pair.first << "'";
-            }
-
-            file << "]," << std::endl;
-
-            std::vector<std::string> groups;
-            for(auto& group : results){
-                groups.push_back(group.first);
-            }
-            std::sort(groups.begin(), groups.end(), numeric_cmp);
-
-            std::size_t max = 0;
-            for(auto& group_title : groups){
-                file << "['" << group_title << "'";
-
-                for(auto& serie : results[group_title]){
-                    file << ", " << serie.second;
-                    max = std::max(max, serie.second);
-                }
-
-                file << "]," << std::endl;
-            }
+            write_data(file, graph);
 
             file << "]);" << std::endl;
 
@@ -132,6 +481,7 @@ void graphs::output(Output output){
         for(auto& graph : all_graphs){
             file << "<div id=\"graph_" << graph->name << "\" style=\"width: 700px; height: 400px;\"></div>" << std::endl;
             file << "<input id=\"graph_button_" << graph->name << "\" type=\"button\" value=\"Logarithmic scale\">" << std::endl;
+            write_counters(file, graph);
         }
 
         file << "</body>" << std::endl;
@@ -146,37 +496,196 @@ void graphs::output(Output output){
             file << "[line_chart width=\"700px\" height=\"400px\" scale_button=\"true\" title=\"" << graph->title
                 << "\" h_title=\"Number of elements\" v_title=\"" << graph->unit << "\"]" << std::endl;
 
-            //['x', 'Cats', 'Blanket 1', 'Blanket 2'],
-            auto results = compute_values(graph);
+            write_data(file, graph);
 
-            file << "['x'";
+            file << "[/line_chart]" << std::endl;
+            write_counters(file, graph);
+        }
+    }
+}
 
-            auto first = results.begin()->second;
-            for(auto& pair : first){
-                file << ", '" << pair.first << "'";
+//Regressions against a baseline run
+
+namespace {
+
+std::unordered_map<std::string, std::vector<double>> baseline;
+
+//A serie can appear several times for the same group, the occurrence number tells them apart
+std::string baseline_key(const std::string& graph, const std::string& serie, const std::string& group, std::size_t occurrence){
+    return graph + '\n' + serie + '\n' + group + '\n' + std::to_string(occurrence);
+}
+
+std::vector<std::string> parse_csv_line(const std::string& line){
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+
+    for(std::size_t i = 0; i < line.size(); ++i){
+        char c = line[i];
+
+        if(quoted){
+            if(c == '"' && i + 1 < line.size() && line[i + 1] == '"'){
+                fields.back() += '"';
+                ++i;
+            } else if(c == '"'){
+                quoted = false;
+            } else {
+                fields.back() += c;
             }
+        } else if(c == '"'){
+            quoted = true;
+        } else if(c == ','){
+            fields.emplace_back();
+        } else {
+            fields.back() += c;
+        }
+    }
+
+    return fields;
+}
+
+double median(std::vector<double> samples){
+    std::sort(samples.begin(), samples.end());
+
+    const std::size_t n = samples.size();
+    return n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+}
+
+//One-sided p-value of the Mann-Whitney U test that the current samples are
+//larger than the baseline ones (normal approximation, with tie correction)
+double mann_whitney(const std::vector<double>& current, const std::vector<double>& previous){
+    const double n1 = current.size();
+    const double n2 = previous.size();
+    const double n = n1 + n2;
+
+    std::vector<std::pair<double, bool>> all;
+    for(auto sample : current){
+        all.push_back({sample, true});
+    }
+    for(auto sample : previous){
+        all.push_back({sample, false});
+    }
+
+    std::sort(all.begin(), all.end());
 
-            file << "]," << std::endl;
+    double rank_sum = 0.0;
+    double ties = 0.0;
 
-            std::vector<std::string> groups;
-            for(auto& group : results){
-                groups.push_back(group.first);
+    for(std::size_t i = 0; i < all.size();){
+        std::size_t j = i;
+        while(j < all.size() && all[j].first == all[i].first){
+            ++j;
+        }
+
+        const double t = j - i;
+        const double rank = (i + 1 + j) / 2.0;
+
+        for(std::size_t k = i; k < j; ++k){
+            if(all[k].second){
+                rank_sum += rank;
             }
-            std::sort(groups.begin(), groups.end(), numeric_cmp);
+        }
+
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    const double u = rank_sum - n1 * (n1 + 1) / 2.0;
+    const double mean = n1 * n2 / 2.0;
+    const double variance = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+
+    if(variance <= 0.0){
+        return 1.0;
+    }
+
+    const double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+} //end of anonymous namespace
+
+bool graphs::load_baseline(const std::string& file){
+    std::ifstream stream(file);
+
+    if(!stream){
+        std::cerr << "Cannot open the baseline " << file << std::endl;
+        return false;
+    }
+
+    std::string line;
+    std::getline(stream, line);
+
+    auto header = parse_csv_line(line);
+    auto column = [&header](const std::string& name){
+        return std::find(header.begin(), header.end(), name) - header.begin();
+    };
 
-            std::size_t max = 0;
-            for(auto& group_title : groups){
-                file << "['" << group_title << "'";
+    const std::size_t graph = column("graph");
+    const std::size_t serie = column("serie");
+    const std::size_t group = column("group");
+    const std::size_t samples = column("samples_ns");
 
-                for(auto& serie : results[group_title]){
-                    file << ", " << serie.second;
-                    max = std::max(max, serie.second);
-                }
+    if(samples >= header.size()){
+        std::cerr << "Invalid baseline " << file << std::endl;
+        return false;
+    }
+
+    std::unordered_map<std::string, std::size_t> occurrences;
+
+    while(std::getline(stream, line)){
+        auto fields = parse_csv_line(line);
+
+        if(fields.size() != header.size()){
+            continue;
+        }
+
+        auto key = baseline_key(fields[graph], fields[serie], fields[group], 0);
+        key = baseline_key(fields[graph], fields[serie], fields[group], occurrences[key]++);
+
+        std::istringstream values(fields[samples]);
+        std::vector<double> parsed;
+
+        double value;
+        while(values >> value){
+            parsed.push_back(value);
+        }
+
+        baseline[key] = parsed;
+    }
+
+    std::cout << "Loaded " << baseline.size() << " baseline results from " << file << std::endl;
 
-                file << "]," << std::endl;
+    return true;
+}
+
+std::size_t graphs::check_regressions(double threshold, double alpha){
+    std::size_t regressions = 0;
+
+    for(auto& graph : all_graphs){
+        std::unordered_map<std::string, std::size_t> occurrences;
+
+        for(auto& result : sorted_results(graph)){
+            auto key = baseline_key(graph->name, result.serie, result.group, 0);
+            key = baseline_key(graph->name, result.serie, result.group, occurrences[key]++);
+
+            auto it = baseline.find(key);
+            if(it == baseline.end() || it->second.empty() || result.samples.empty()){
+                continue;
             }
 
-            file << "[/line_chart]" << std::endl;
+            const double before = median(it->second);
+            const double after = median(result.samples);
+            const double p = mann_whitney(result.samples, it->second);
+
+            if(after > before * (1.0 + threshold) && p < alpha){
+                ++regressions;
+
+                std::cout << "REGRESSION " << graph->name << ":" << result.serie << ":" << result.group
+                    << " median " << before << "ns -> " << after << "ns (+" << (after / before - 1.0) * 100.0 << "%, p=" << p << ")" << std::endl;
+            }
         }
     }
+
+    std::cout << regressions << " regression(s) against the baseline" << std::endl;
+
+    return regressions;
 }
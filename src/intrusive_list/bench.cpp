@@ -17,6 +17,9 @@
 
 #include <boost/intrusive/list.hpp>
 
+#include "plf_timsort.h"
+#include "plf_colony.h"
+
 #include "bench.hpp"
 #include "policies.hpp"
 
@@ -196,7 +199,12 @@ void bench_all(){
 
 } //end of anonymous namespace
 
-int main(){
+int main(int argc, char* argv[]){
+    //The optional argument is the graph.csv of a previous run to compare with
+    if(argc > 1 && !graphs::load_baseline(argv[1])){
+        return 1;
+    }
+
     bench_all<
         Normal<8>,
         Normal<32>,
@@ -205,6 +213,12 @@ int main(){
         //Normal<4096>>();
 
     graphs::output(graphs::Output::PLUGIN);
+    graphs::output(graphs::Output::JSON);
+    graphs::output(graphs::Output::CSV);
+
+    if(argc > 1 && graphs::check_regressions()){
+        return 1;
+    }
 
     return 0;
 }
@@ -0,0 +1,174 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <iostream>
+#include <sstream>
+
+#include "isolation.hpp"
+
+#ifdef __linux__
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#endif
+
+namespace {
+
+std::string serialize(const isolation::measurement& m){
+    std::ostringstream stream;
+    stream.precision(17);
+
+    stream << m.hw.cycles << " " << m.hw.instructions << " " << m.hw.cache_misses << " "
+           << m.hw.branch_misses << " " << m.hw.dtlb_misses << " "
+           << m.heap.count << " " << m.heap.bytes << " " << m.heap.peak_bytes << " " << m.heap.time << " " << m.samples.size();
+
+    for(auto sample : m.samples){
+        stream << " " << sample;
+    }
+
+    return stream.str();
+}
+
+bool deserialize(const std::string& data, isolation::measurement& m){
+    std::istringstream stream(data);
+    std::size_t n = 0;
+
+    stream >> m.hw.cycles >> m.hw.instructions >> m.hw.cache_misses >> m.hw.branch_misses >> m.hw.dtlb_misses;
+    stream >> m.heap.count >> m.heap.bytes >> m.heap.peak_bytes >> m.heap.time >> n;
+
+    m.samples.resize(n);
+    for(auto& sample : m.samples){
+        stream >> sample;
+    }
+
+    return !stream.fail();
+}
+
+} //end of anonymous namespace
+
+isolation::settings& isolation::current(){
+    static settings s{false, -1, false};
+    return s;
+}
+
+#ifdef __linux__
+
+bool isolation::apply(){
+    bool success = true;
+
+    if(current().cpu >= 0){
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(current().cpu, &set);
+
+        if(sched_setaffinity(0, sizeof(set), &set) != 0){
+            std::cerr << "Cannot pin the benchmark to the core " << current().cpu << std::endl;
+            success = false;
+        }
+    }
+
+    if(current().lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0){
+        std::cerr << "Cannot lock the memory of the benchmark" << std::endl;
+        success = false;
+    }
+
+    return success;
+}
+
+bool isolation::run(const std::function<measurement()>& measure, measurement& result){
+    if(!current().enabled){
+        result = measure();
+        return true;
+    }
+
+    int fds[2];
+    if(pipe(fds) != 0){
+        std::cerr << "Cannot create the pipe to the benchmark process" << std::endl;
+        return false;
+    }
+
+    // do not let the child output again what is still buffered
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+
+    if(pid < 0){
+        std::cerr << "Cannot fork the benchmark process" << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if(pid == 0){
+        close(fds[0]);
+
+        // an unpinned or unlocked cell is not recorded, as in-process
+        if(!apply()){
+            close(fds[1]);
+            _exit(1);
+        }
+
+        auto data = serialize(measure());
+
+        const char* buffer = data.c_str();
+        std::size_t remaining = data.size();
+
+        while(remaining){
+            auto written = write(fds[1], buffer, remaining);
+            if(written <= 0){
+                break;
+            }
+
+            buffer += written;
+            remaining -= written;
+        }
+
+        close(fds[1]);
+
+        std::cout.flush();
+        _exit(remaining ? 1 : 0);
+    }
+
+    close(fds[1]);
+
+    std::string data;
+    char buffer[4096];
+    ssize_t count;
+
+    while((count = read(fds[0], buffer, sizeof(buffer))) > 0){
+        data.append(buffer, count);
+    }
+
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !deserialize(data, result)){
+        std::cerr << "The benchmark process failed" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+#else
+
+bool isolation::apply(){
+    return current().cpu < 0 && !current().lock_memory;
+}
+
+bool isolation::run(const std::function<measurement()>& measure, measurement& result){
+    result = measure();
+    return true;
+}
+
+#endif
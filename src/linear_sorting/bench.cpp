@@ -11,6 +11,20 @@
 #include <iostream>
 #include <algorithm>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <cstdint>
+
+#include "plf_timsort.h"
+
+#include "generators.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define HISTOGRAM_AVX2
+#include <immintrin.h>
+#endif
 
 //Chrono typedefs
 typedef std::chrono::high_resolution_clock Clock;
@@ -20,14 +34,40 @@ static const std::size_t SIZE = 5000000;
 static const std::size_t MAX =  SIZE * 10;
 static const std::size_t REPEAT = 25;
 
+//For the record sorts
+static const std::size_t RECORDS = 250000;
+static const std::size_t RECORDS_MAX = RECORDS * 10;
+
 static const bool DISPLAY = false;
 
-void fill_random(std::vector<std::size_t>& vec, std::size_t size){
+void fill_random(std::vector<std::size_t>& vec, std::size_t size, std::size_t max = MAX,
+        generators::Distribution distribution = generators::Distribution::UNIFORM, std::size_t seed = generators::default_seed){
+    generators::fill(vec, size, max, distribution, seed);
+}
+
+// trivial record with parametrized size, sorted on a
+template<int N>
+struct Trivial {
+    std::size_t a;
+    std::array<unsigned char, N-sizeof(a)> b;
+    bool operator<(const Trivial &other) const { return a < other.a; }
+};
+
+template<>
+struct Trivial<sizeof(std::size_t)> {
+    std::size_t a;
+    bool operator<(const Trivial &other) const { return a < other.a; }
+};
+
+template<typename Record>
+void fill_records(std::vector<Record>& vec, std::size_t size){
     std::mt19937 generator;
-    std::uniform_int_distribution<std::size_t> distribution(0, MAX);
+    std::uniform_int_distribution<std::size_t> distribution(0, RECORDS_MAX);
+
+    vec.resize(size);
 
     for(std::size_t i = 0; i < size; ++i){
-        vec.push_back(distribution(generator));
+        vec[i].a = distribution(generator);
     }
 }
 
@@ -45,19 +85,163 @@ void display_vec(std::vector<std::size_t>& vec){
     }
 }
 
+//Histogram kernel shared by the linear sorts: adds the number of keys of
+//each digit ((key - base) >> shift) & mask in [first, last) to cnt[digit].
+//
+//Consecutive keys falling in the same bin serialize on the increment of
+//that bin, so small tables are split into several interleaved
+//sub-histograms that are reduced at the end.
+
+static const std::size_t histogram_ways = 4;
+static const std::size_t histogram_max_interleaved = 1 << 12;   //Bins
+
+void histogram_plain(const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t base, std::size_t shift, std::size_t mask){
+    for(; first != last; ++first){
+        ++cnt[((*first - base) >> shift) & mask];
+    }
+}
+
+void histogram_reduce(const std::vector<std::size_t>& sub, std::size_t* cnt, std::size_t bins){
+    for(std::size_t w = 0; w < histogram_ways; ++w){
+        for(std::size_t d = 0; d < bins; ++d){
+            cnt[d] += sub[w * bins + d];
+        }
+    }
+}
+
+void histogram_interleaved(const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t bins, std::size_t base, std::size_t shift, std::size_t mask){
+    std::vector<std::size_t> sub(histogram_ways * bins);
+
+    std::size_t* c0 = sub.data();
+    std::size_t* c1 = c0 + bins;
+    std::size_t* c2 = c1 + bins;
+    std::size_t* c3 = c2 + bins;
+
+    for(; last - first >= 4; first += 4){
+        ++c0[((first[0] - base) >> shift) & mask];
+        ++c1[((first[1] - base) >> shift) & mask];
+        ++c2[((first[2] - base) >> shift) & mask];
+        ++c3[((first[3] - base) >> shift) & mask];
+    }
+
+    histogram_plain(first, last, c0, base, shift, mask);
+    histogram_reduce(sub, cnt, bins);
+}
+
+#ifdef HISTOGRAM_AVX2
+
+//Same as histogram_interleaved, but the four digits are extracted at once
+__attribute__((target("avx2")))
+void histogram_interleaved_avx2(const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t bins, std::size_t base, std::size_t shift, std::size_t mask){
+    std::vector<std::size_t> sub(histogram_ways * bins);
+
+    std::size_t* c0 = sub.data();
+    std::size_t* c1 = c0 + bins;
+    std::size_t* c2 = c1 + bins;
+    std::size_t* c3 = c2 + bins;
+
+    const __m256i base_v = _mm256_set1_epi64x(base);
+    const __m256i mask_v = _mm256_set1_epi64x(mask);
+    const __m128i shift_v = _mm_cvtsi64_si128(shift);
+
+    alignas(32) std::uint64_t digits[4];
+
+    for(; last - first >= 4; first += 4){
+        __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        keys = _mm256_and_si256(_mm256_srl_epi64(_mm256_sub_epi64(keys, base_v), shift_v), mask_v);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(digits), keys);
+
+        ++c0[digits[0]];
+        ++c1[digits[1]];
+        ++c2[digits[2]];
+        ++c3[digits[3]];
+    }
+
+    histogram_plain(first, last, c0, base, shift, mask);
+    histogram_reduce(sub, cnt, bins);
+}
+
+bool has_avx2(){
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+#endif
+
+//All the digits must be lower than bins
+void histogram(const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t bins, std::size_t base = 0, std::size_t shift = 0, std::size_t mask = ~std::size_t(0)){
+    //The sub-histograms of large tables would not fit in cache
+    if(bins > histogram_max_interleaved){
+        histogram_plain(first, last, cnt, base, shift, mask);
+        return;
+    }
+
+#ifdef HISTOGRAM_AVX2
+    if(has_avx2()){
+        histogram_interleaved_avx2(first, last, cnt, bins, base, shift, mask);
+        return;
+    }
+#endif
+
+    histogram_interleaved(first, last, cnt, bins, base, shift, mask);
+}
+
+//Same kernel for records whose keys are read through key(record). The keys
+//are not contiguous, so there is no vectorized digit extraction, but the
+//interleaved sub-histograms apply all the same.
+
+template<typename Record, typename KeyExtractor>
+void histogram_plain(const Record* first, const Record* last, KeyExtractor key, std::size_t* cnt, std::size_t base, std::size_t shift, std::size_t mask){
+    for(; first != last; ++first){
+        ++cnt[((key(*first) - base) >> shift) & mask];
+    }
+}
+
+template<typename Record, typename KeyExtractor>
+void histogram_interleaved(const Record* first, const Record* last, KeyExtractor key, std::size_t* cnt, std::size_t bins, std::size_t base, std::size_t shift, std::size_t mask){
+    std::vector<std::size_t> sub(histogram_ways * bins);
+
+    std::size_t* c0 = sub.data();
+    std::size_t* c1 = c0 + bins;
+    std::size_t* c2 = c1 + bins;
+    std::size_t* c3 = c2 + bins;
+
+    for(; last - first >= 4; first += 4){
+        ++c0[((key(first[0]) - base) >> shift) & mask];
+        ++c1[((key(first[1]) - base) >> shift) & mask];
+        ++c2[((key(first[2]) - base) >> shift) & mask];
+        ++c3[((key(first[3]) - base) >> shift) & mask];
+    }
+
+    histogram_plain(first, last, key, c0, base, shift, mask);
+    histogram_reduce(sub, cnt, bins);
+}
+
+template<typename Record, typename KeyExtractor>
+void histogram(const Record* first, const Record* last, KeyExtractor key, std::size_t* cnt, std::size_t bins, std::size_t base = 0, std::size_t shift = 0, std::size_t mask = ~std::size_t(0)){
+    if(bins > histogram_max_interleaved){
+        histogram_plain(first, last, key, cnt, base, shift, mask);
+        return;
+    }
+
+    histogram_interleaved(first, last, key, cnt, bins, base, shift, mask);
+}
+
 void std_sort(std::vector<std::size_t>& A){
     std::sort(A.begin(), A.end());
 }
 
+void timsort(std::vector<std::size_t>& A){
+    plf::timsort(A.begin(), A.end());
+}
+
 void in_place_counting_sort(std::vector<std::size_t>& A){
     std::vector<std::size_t> C(MAX + 1);
 
-    for (std::size_t i = 0; i < SIZE; ++i){
-        ++C[A[i]];
-    }
+    histogram(A.data(), A.data() + SIZE, C.data(), C.size());
 
-    int current = 0;
-    for (std::size_t i = 0; i < MAX; ++i){
+    std::size_t current = 0;
+    for (std::size_t i = 0; i <= MAX; ++i){
         for(std::size_t j =0; j < C[i]; ++j){
             A[current++] = i;
         }
@@ -66,11 +250,9 @@ void in_place_counting_sort(std::vector<std::size_t>& A){
 
 void counting_sort(std::vector<std::size_t>& A){
     std::vector<std::size_t> B(SIZE);
-    std::vector<std::size_t> C(MAX);
+    std::vector<std::size_t> C(MAX + 1);
 
-    for (std::size_t i = 0; i < SIZE; ++i){
-        ++C[A[i]];
-    }
+    histogram(A.data(), A.data() + SIZE, C.data(), C.size());
 
     for (std::size_t i = 1; i <= MAX; ++i){
         C[i] += C[i - 1];
@@ -86,7 +268,8 @@ void counting_sort(std::vector<std::size_t>& A){
     }
 }
 
-void binsort(std::vector<std::size_t>& A){
+//One vector per bin, kept for reference
+void vector_binsort(std::vector<std::size_t>& A){
     std::vector<std::vector<std::size_t>> B(MAX + 1);
 
     for(std::size_t i = 0; i < SIZE; ++i){
@@ -94,13 +277,99 @@ void binsort(std::vector<std::size_t>& A){
     }
 
     std::size_t current = 0;
-    for(std::size_t i = 0; i < MAX; ++i){
+    for(std::size_t i = 0; i <= MAX; ++i){
         for(auto item : B[i]){
             A[current++] = item;
         }
     }
 }
 
+//All the bins are laid out in one arena, at the offsets given by the
+//prefix sum of their sizes
+void binsort(std::vector<std::size_t>& A){
+    std::vector<std::size_t> start(MAX + 2);
+
+    histogram(A.data(), A.data() + A.size(), start.data() + 1, MAX + 1);
+
+    for(std::size_t i = 1; i < start.size(); ++i){
+        start[i] += start[i - 1];
+    }
+
+    std::vector<std::size_t> arena(A.size());
+
+    for(auto key : A){
+        arena[start[key]++] = key;
+    }
+
+    A.swap(arena);
+}
+
+//For the bucket of buckets binsort, both levels of counters fit in a 256KB L2
+static const std::size_t top_bucket_bits = 12;      //32KB of counters
+static const std::size_t low_bucket_bits = 14;      //128KB of counters
+
+//The top level scatters the keys into buckets of their high bits, then
+//each bucket is binsorted on its low bits back into A
+void msd_binsort(std::vector<std::size_t>& A){
+    if(A.empty()){
+        return;
+    }
+
+    auto minmax = std::minmax_element(A.begin(), A.end());
+    auto min = *minmax.first;
+    auto range = *minmax.second - min;
+
+    std::size_t range_bits = 0;
+    while(range_bits < sizeof(std::size_t) * 8 && (range >> range_bits)){
+        ++range_bits;
+    }
+
+    const std::size_t low_bits = std::min(range_bits, low_bucket_bits);
+    const std::size_t shift = std::max(low_bits, range_bits > top_bucket_bits ? range_bits - top_bucket_bits : 0);
+
+    std::vector<std::size_t> top((range >> shift) + 2);
+
+    histogram(A.data(), A.data() + A.size(), top.data() + 1, top.size() - 1, min, shift);
+
+    for(std::size_t i = 1; i < top.size(); ++i){
+        top[i] += top[i - 1];
+    }
+
+    std::vector<std::size_t> arena(A.size());
+    std::vector<std::size_t> next(top.begin(), top.end() - 1);
+
+    for(auto key : A){
+        arena[next[(key - min) >> shift]++] = key;
+    }
+
+    const std::size_t low_mask = (std::size_t(1) << low_bits) - 1;
+    std::vector<std::size_t> low(low_mask + 2);
+
+    for(std::size_t b = 0; b + 1 < top.size(); ++b){
+        auto first = arena.data() + top[b];
+        auto last = arena.data() + top[b + 1];
+
+        //The low bits do not cover the rest of the key, too wide for a bin per key
+        if(shift != low_bits){
+            std::copy(first, last, A.begin() + top[b]);
+            std::sort(A.begin() + top[b], A.begin() + top[b + 1]);
+            continue;
+        }
+
+        std::fill(low.begin(), low.end(), 0);
+
+        histogram(first, last, low.data() + 1, low.size() - 1, min, 0, low_mask);
+
+        for(std::size_t i = 1; i < low.size(); ++i){
+            low[i] += low[i - 1];
+        }
+
+        for(auto it = first; it != last; ++it){
+            A[top[b] + low[(*it - min) & low_mask]++] = *it;
+        }
+    }
+}
+
 //For radix sort
 static const std::size_t digits = 2;        //Digits
 static const std::size_t r = 16;            //Bits
@@ -116,9 +385,7 @@ void radix_sort(std::vector<std::size_t>& A){
             cnt[j] = 0;
         }
 
-        for(std::size_t j = 0; j < SIZE; ++j){
-            ++cnt[(A[j] >> shift) & mask];
-        }
+        histogram(A.data(), A.data() + SIZE, cnt.data(), radix, 0, shift, mask);
 
         for(std::size_t j = 1; j < radix; ++j){
             cnt[j] += cnt[j - 1];
@@ -134,12 +401,500 @@ void radix_sort(std::vector<std::size_t>& A){
     }
 }
 
+//For the full width radix sorts
+static const std::size_t wide_bits = 8;                                 //Bits per digit
+static const std::size_t wide_radix = 1 << wide_bits;                   //Bins
+static const std::size_t wide_mask = wide_radix - 1;
+static const std::size_t wide_digits = sizeof(std::size_t) * 8 / wide_bits; //Digits
+
+//Run function(t) on threads threads, the calling thread being the thread 0.
+//The threads are only started once per sort, its phases are separated by
+//a barrier rather than by a new parallel_run
 template<typename Function>
-void bench(Function sort_function){
+void parallel_run(std::size_t threads, Function function){
+    std::vector<std::thread> pool;
+
+    for(std::size_t t = 1; t < threads; ++t){
+        pool.push_back(std::thread(function, t));
+    }
+
+    function(0);
+
+    for(auto& thread : pool){
+        thread.join();
+    }
+}
+
+//Blocks the threads of a parallel_run until all of them have reached it
+class barrier {
+    public:
+        explicit barrier(std::size_t threads) : threads(threads) {}
+
+        void wait(){
+            std::unique_lock<std::mutex> lock(mutex);
+
+            const std::size_t current = generation;
+
+            if(++waiting == threads){
+                waiting = 0;
+                ++generation;
+                condition.notify_all();
+            } else {
+                condition.wait(lock, [&]{ return generation != current; });
+            }
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        const std::size_t threads;
+        std::size_t waiting = 0;
+        std::size_t generation = 0;
+};
+
+void parallel_radix_sort(std::vector<std::size_t>& A, std::size_t threads){
+    const std::size_t n = A.size();
+    const std::size_t chunk = (n + threads - 1) / threads;
+    const std::size_t digit_chunk = (wide_radix + threads - 1) / threads;
+
+    std::vector<std::size_t> B(n);
+
+    //One histogram per thread, later turned into the per-thread scatter offsets
+    std::vector<std::array<std::size_t, wide_radix>> cnt(threads);
+
+    //Total of the keys of each range of digits of the prefix sum
+    std::vector<std::size_t> totals(threads);
+
+    //A digit is only worth a pass if at least two keys differ on it
+    std::vector<std::size_t> ands(threads, ~std::size_t(0));
+    std::vector<std::size_t> ors(threads, 0);
+
+    barrier sync(threads);
+
+    //Where the sorted keys ended, written by the thread 0
+    std::size_t* sorted = A.data();
+
+    parallel_run(threads, [&](std::size_t t){
+        const std::size_t first = std::min(n, t * chunk);
+        const std::size_t last = std::min(n, (t + 1) * chunk);
+
+        std::size_t local_and = ~std::size_t(0);
+        std::size_t local_or = 0;
+
+        for(std::size_t j = first; j < last; ++j){
+            local_and &= A[j];
+            local_or |= A[j];
+        }
+
+        ands[t] = local_and;
+        ors[t] = local_or;
+
+        sync.wait();
+
+        //Every thread reduces the masks, so they all skip the same digits
+        std::size_t all_and = ~std::size_t(0);
+        std::size_t all_or = 0;
+        for(std::size_t u = 0; u < threads; ++u){
+            all_and &= ands[u];
+            all_or |= ors[u];
+        }
+
+        const std::size_t differ = all_and ^ all_or;
+
+        std::size_t* src = A.data();
+        std::size_t* dst = B.data();
+
+        std::vector<std::size_t> offsets(threads);
+
+        for(std::size_t i = 0, shift = 0; i < wide_digits; ++i, shift += wide_bits){
+            if(!((differ >> shift) & wide_mask)){
+                continue;
+            }
+
+            //1. Local histograms
+
+            auto& local = cnt[t];
+            local.fill(0);
+
+            histogram(src + first, src + last, local.data(), wide_radix, 0, shift, wide_mask);
+
+            sync.wait();
+
+            //2. Prefix sum in digit major, thread minor order. Each thread
+            //scans a range of digits, then shifts it by the total of the
+            //previous ranges
+
+            std::size_t sum = 0;
+
+            for(std::size_t d = t * digit_chunk; d < std::min(wide_radix, (t + 1) * digit_chunk); ++d){
+                for(std::size_t u = 0; u < threads; ++u){
+                    auto count = cnt[u][d];
+                    cnt[u][d] = sum;
+                    sum += count;
+                }
+            }
+
+            totals[t] = sum;
+
+            sync.wait();
+
+            //3. Scatter, each thread writes its keys at its own offsets
+
+            std::size_t offset = 0;
+            for(std::size_t u = 0; u < threads; ++u){
+                offsets[u] = offset;
+                offset += totals[u];
+            }
+
+            for(std::size_t d = 0; d < wide_radix; ++d){
+                local[d] += offsets[d / digit_chunk];
+            }
+
+            for(std::size_t j = first; j < last; ++j){
+                dst[local[(src[j] >> shift) & wide_mask]++] = src[j];
+            }
+
+            //The next pass reads what the other threads have written
+            sync.wait();
+
+            std::swap(src, dst);
+        }
+
+        if(t == 0){
+            sorted = src;
+        }
+    });
+
+    //The sorted keys may have ended in the temporary buffer
+    if(sorted != A.data()){
+        A.swap(B);
+    }
+}
+
+//For the sample sort
+static const std::size_t oversampling = 32;     //Samples per bucket
+
+//Parallel comparison sort baseline: the keys are split into one bucket
+//per thread by splitters taken from a sorted random sample, then each
+//thread sorts its bucket with std::sort
+void sample_sort(std::vector<std::size_t>& A, std::size_t threads){
+    const std::size_t n = A.size();
+
+    if(n < threads * oversampling){
+        std::sort(A.begin(), A.end());
+        return;
+    }
+
+    std::mt19937 generator;
+    std::uniform_int_distribution<std::size_t> distribution(0, n - 1);
+
+    std::vector<std::size_t> sample(threads * oversampling);
+    for(auto& key : sample){
+        key = A[distribution(generator)];
+    }
+
+    std::sort(sample.begin(), sample.end());
+
+    std::vector<std::size_t> splitters;
+    for(std::size_t b = 1; b < threads; ++b){
+        splitters.push_back(sample[b * oversampling]);
+    }
+
+    auto bucket = [&splitters](std::size_t key){
+        return std::upper_bound(splitters.begin(), splitters.end(), key) - splitters.begin();
+    };
+
+    const std::size_t chunk = (n + threads - 1) / threads;
+
+    //cnt[t][b] is the number of keys of the chunk t going to the bucket b
+    std::vector<std::vector<std::size_t>> cnt(threads, std::vector<std::size_t>(threads));
+    std::vector<std::size_t> start(threads + 1);
+
+    std::vector<std::size_t> B(n);
+
+    barrier sync(threads);
+
+    parallel_run(threads, [&](std::size_t t){
+        const std::size_t first = std::min(n, t * chunk);
+        const std::size_t last = std::min(n, (t + 1) * chunk);
+
+        for(std::size_t j = first; j < last; ++j){
+            ++cnt[t][bucket(A[j])];
+        }
+
+        sync.wait();
+
+        //The prefix sum is only threads * threads counts
+        if(t == 0){
+            std::size_t sum = 0;
+            for(std::size_t b = 0; b < threads; ++b){
+                start[b] = sum;
+
+                for(std::size_t u = 0; u < threads; ++u){
+                    auto count = cnt[u][b];
+                    cnt[u][b] = sum;
+                    sum += count;
+                }
+            }
+
+            start[threads] = n;
+        }
+
+        sync.wait();
+
+        auto& next = cnt[t];
+
+        for(std::size_t j = first; j < last; ++j){
+            B[next[bucket(A[j])]++] = A[j];
+        }
+
+        sync.wait();
+
+        std::sort(B.begin() + start[t], B.begin() + start[t + 1]);
+    });
+
+    A.swap(B);
+}
+
+//Number of elements of a among the k first elements of the stable merge
+//of a and b
+std::size_t merge_split(const std::size_t* a, std::size_t na, const std::size_t* b, std::size_t nb, std::size_t k){
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = std::min(k, na);
+
+    while(lo < hi){
+        std::size_t i = lo + (hi - lo) / 2;
+
+        if(a[i] <= b[k - i - 1]){
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+
+    return lo;
+}
+
+//Each thread sorts one chunk, then the runs are merged pairwise. In each
+//round, every thread produces an equal slice of the output, so the last
+//merges are as parallel as the first ones
+void parallel_merge_sort(std::vector<std::size_t>& A, std::size_t threads){
+    const std::size_t n = A.size();
+    const std::size_t chunk = std::max<std::size_t>(1, (n + threads - 1) / threads);
+
+    std::vector<std::size_t> B(n);
+
+    barrier sync(threads);
+
+    //Where the sorted keys ended, written by the thread 0
+    std::size_t* sorted = A.data();
+
+    parallel_run(threads, [&](std::size_t t){
+        std::sort(A.begin() + std::min(n, t * chunk), A.begin() + std::min(n, (t + 1) * chunk));
+
+        const std::size_t first = n * t / threads;
+        const std::size_t last = n * (t + 1) / threads;
+
+        std::size_t* src = A.data();
+        std::size_t* dst = B.data();
+
+        for(std::size_t width = chunk; width < n; width *= 2){
+            //The runs of the previous round are written by other threads
+            sync.wait();
+
+            for(std::size_t pair = first / (2 * width) * (2 * width); pair < last; pair += 2 * width){
+                const std::size_t* a = src + pair;
+                const std::size_t na = std::min(width, n - pair);
+                const std::size_t* b = a + na;
+                const std::size_t nb = std::min(width, n - pair - na);
+
+                const std::size_t k0 = std::max(first, pair) - pair;
+                const std::size_t k1 = std::min(last, pair + na + nb) - pair;
+
+                const std::size_t i0 = merge_split(a, na, b, nb, k0);
+                const std::size_t i1 = merge_split(a, na, b, nb, k1);
+
+                std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), dst + pair + k0);
+            }
+
+            std::swap(src, dst);
+        }
+
+        if(t == 0){
+            sorted = src;
+        }
+    });
+
+    if(sorted != A.data()){
+        A.swap(B);
+    }
+}
+
+//Sort records on the key returned by key(record), moving the whole records
+
+template<typename Record, typename KeyExtractor>
+void counting_sort(std::vector<Record>& A, KeyExtractor key, std::size_t max){
+    std::vector<Record> B(A.size());
+    std::vector<std::size_t> C(max + 1);
+
+    histogram(A.data(), A.data() + A.size(), key, C.data(), C.size());
+
+    std::size_t sum = 0;
+    for(auto& count : C){
+        auto current = count;
+        count = sum;
+        sum += current;
+    }
+
+    for(auto& record : A){
+        B[C[key(record)]++] = std::move(record);
+    }
+
+    A.swap(B);
+}
+
+template<typename Record, typename KeyExtractor>
+void radix_sort(std::vector<Record>& A, KeyExtractor key){
+    std::size_t all_and = ~std::size_t(0);
+    std::size_t all_or = 0;
+
+    for(auto& record : A){
+        all_and &= key(record);
+        all_or |= key(record);
+    }
+
+    const std::size_t differ = all_and ^ all_or;
+
+    std::vector<Record> B(A.size());
+    std::array<std::size_t, wide_radix> cnt;
+
+    Record* src = A.data();
+    Record* dst = B.data();
+
+    for(std::size_t i = 0, shift = 0; i < wide_digits; ++i, shift += wide_bits){
+        if(!((differ >> shift) & wide_mask)){
+            continue;
+        }
+
+        cnt.fill(0);
+
+        histogram(src, src + A.size(), key, cnt.data(), wide_radix, 0, shift, wide_mask);
+
+        std::size_t sum = 0;
+        for(auto& count : cnt){
+            auto current = count;
+            count = sum;
+            sum += current;
+        }
+
+        for(std::size_t j = 0; j < A.size(); ++j){
+            dst[cnt[(key(src[j]) >> shift) & wide_mask]++] = std::move(src[j]);
+        }
+
+        std::swap(src, dst);
+    }
+
+    if(src != A.data()){
+        A.swap(B);
+    }
+}
+
+//Index permutation mode: only (key, index) pairs are sorted and the
+//records are moved once at the end
+
+struct key_index {
+    std::size_t key;
+    std::size_t index;
+};
+
+template<typename Record, typename KeyExtractor>
+std::vector<key_index> make_key_indices(const std::vector<Record>& A, KeyExtractor key){
+    std::vector<key_index> P(A.size());
+
+    for(std::size_t i = 0; i < A.size(); ++i){
+        P[i] = {key(A[i]), i};
+    }
+
+    return P;
+}
+
+//Move A[P[i].index] to A[i] by following the cycles of the permutation
+template<typename Record>
+void apply_permutation(std::vector<Record>& A, std::vector<key_index>& P){
+    for(std::size_t i = 0; i < A.size(); ++i){
+        if(P[i].index == i){
+            continue;
+        }
+
+        Record tmp = std::move(A[i]);
+
+        std::size_t j = i;
+        while(P[j].index != i){
+            auto next = P[j].index;
+            A[j] = std::move(A[next]);
+            P[j].index = j;
+            j = next;
+        }
+
+        A[j] = std::move(tmp);
+        P[j].index = j;
+    }
+}
+
+template<typename Record, typename KeyExtractor>
+void counting_sort_indirect(std::vector<Record>& A, KeyExtractor key, std::size_t max){
+    auto P = make_key_indices(A, key);
+    counting_sort(P, [](const key_index& e){ return e.key; }, max);
+    apply_permutation(A, P);
+}
+
+template<typename Record, typename KeyExtractor>
+void radix_sort_indirect(std::vector<Record>& A, KeyExtractor key){
+    auto P = make_key_indices(A, key);
+    radix_sort(P, [](const key_index& e){ return e.key; });
+    apply_permutation(A, P);
+}
+
+//For the adaptive counting sort
+static const std::size_t adaptive_counters = 2;         //Maximum counters per key
+static const std::size_t adaptive_min_counters = 1 << 16;
+
+//In place counting sort of keys in [min, max]
+void counting_sort_range(std::vector<std::size_t>& A, std::size_t min, std::size_t max){
+    std::vector<std::size_t> C(max - min + 1);
+
+    histogram(A.data(), A.data() + A.size(), C.data(), C.size(), min);
+
+    auto current = A.begin();
+    for(std::size_t i = 0; i < C.size(); ++i){
+        current = std::fill_n(current, C[i], min + i);
+    }
+}
+
+//Size the histogram on the actual key range, or fall back to a radix
+//sort when the histogram would be much larger than the input
+void adaptive_counting_sort(std::vector<std::size_t>& A){
+    if(A.empty()){
+        return;
+    }
+
+    auto minmax = std::minmax_element(A.begin(), A.end());
+    auto min = *minmax.first;
+    auto max = *minmax.second;
+
+    if(max - min < std::max(A.size() * adaptive_counters, adaptive_min_counters)){
+        counting_sort_range(A, min, max);
+    } else {
+        radix_sort(A, [min](std::size_t key){ return key - min; });
+    }
+}
+
+template<typename Function>
+void bench(Function sort_function, std::size_t max = MAX, generators::Distribution distribution = generators::Distribution::UNIFORM){
     std::array<std::vector<std::size_t>, REPEAT> vec;
 
     for(std::size_t i = 0; i < REPEAT; ++i){
-        fill_random(vec[i], SIZE);
+        fill_random(vec[i], SIZE, max, distribution);
     }
 
     Clock::time_point t0 = Clock::now();
@@ -158,21 +913,189 @@ void bench(Function sort_function){
     }
 }
 
+//Only count the 8-bit digits of all the keys, as a 64-bit radix sort does
+static std::size_t histogram_sink = 0;
+
+template<typename Function>
+void bench_histogram(Function histogram_function){
+    std::vector<std::size_t> vec;
+    fill_random(vec, SIZE);
+
+    std::array<std::size_t, wide_radix> cnt;
+
+    Clock::time_point t0 = Clock::now();
+
+    for(std::size_t i = 0; i < REPEAT; ++i){
+        for(std::size_t shift = 0; shift < wide_digits * wide_bits; shift += wide_bits){
+            cnt.fill(0);
+            histogram_function(vec.data(), vec.data() + vec.size(), cnt.data(), shift);
+            histogram_sink += cnt[0];
+        }
+    }
+
+    Clock::time_point t1 = Clock::now();
+    milliseconds ms = std::chrono::duration_cast<milliseconds>(t1 - t0);
+
+    std::cout << ms.count() << "ms" << std::endl;
+}
+
+template<typename Record, typename Function>
+void bench_records(Function sort_function){
+    std::vector<Record> source;
+    fill_records(source, RECORDS);
+
+    std::vector<Record> vec;
+    Clock::duration duration(0);
+
+    for(std::size_t i = 0; i < REPEAT; ++i){
+        vec = source;
+
+        Clock::time_point t0 = Clock::now();
+
+        sort_function(vec);
+
+        Clock::time_point t1 = Clock::now();
+        duration += t1 - t0;
+    }
+
+    milliseconds ms = std::chrono::duration_cast<milliseconds>(duration);
+
+    std::cout << ms.count() << "ms" << std::endl;
+}
+
+template<int N>
+void bench_records(){
+    typedef Trivial<N> Record;
+
+    auto key = [](const Record& record){ return record.a; };
+
+    std::cout << "std::sort<Trivial<" << N << ">>" << std::endl;
+    bench_records<Record>([](std::vector<Record>& A){ std::sort(A.begin(), A.end()); });
+
+    std::cout << "counting_sort<Trivial<" << N << ">>" << std::endl;
+    bench_records<Record>([key](std::vector<Record>& A){ counting_sort(A, key, RECORDS_MAX); });
+
+    std::cout << "counting_sort_indirect<Trivial<" << N << ">>" << std::endl;
+    bench_records<Record>([key](std::vector<Record>& A){ counting_sort_indirect(A, key, RECORDS_MAX); });
+
+    std::cout << "radix_sort<Trivial<" << N << ">>" << std::endl;
+    bench_records<Record>([key](std::vector<Record>& A){ radix_sort(A, key); });
+
+    std::cout << "radix_sort_indirect<Trivial<" << N << ">>" << std::endl;
+    bench_records<Record>([key](std::vector<Record>& A){ radix_sort_indirect(A, key); });
+}
+
 int main(){
+    std::cout << "histogram_plain" << std::endl;
+    bench_histogram([](const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t shift){
+        histogram_plain(first, last, cnt, 0, shift, wide_mask);
+    });
+
+    std::cout << "histogram_interleaved" << std::endl;
+    bench_histogram([](const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t shift){
+        histogram_interleaved(first, last, cnt, wide_radix, 0, shift, wide_mask);
+    });
+
+#ifdef HISTOGRAM_AVX2
+    if(has_avx2()){
+        std::cout << "histogram_interleaved_avx2" << std::endl;
+        bench_histogram([](const std::size_t* first, const std::size_t* last, std::size_t* cnt, std::size_t shift){
+            histogram_interleaved_avx2(first, last, cnt, wide_radix, 0, shift, wide_mask);
+        });
+    }
+#endif
+
     std::cout << "std::sort" << std::endl;
     bench(&std_sort);
 
+    const std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // powers of two below max_threads, then max_threads itself
+    std::vector<std::size_t> thread_counts;
+    for(std::size_t threads = 1; threads < max_threads; threads *= 2){
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    for(auto threads : thread_counts){
+        std::cout << "parallel_radix_sort (" << threads << " threads)" << std::endl;
+        bench([threads](std::vector<std::size_t>& A){ parallel_radix_sort(A, threads); });
+
+        std::cout << "sample_sort (" << threads << " threads)" << std::endl;
+        bench([threads](std::vector<std::size_t>& A){ sample_sort(A, threads); });
+
+        std::cout << "parallel_merge_sort (" << threads << " threads)" << std::endl;
+        bench([threads](std::vector<std::size_t>& A){ parallel_merge_sort(A, threads); });
+    }
+
     std::cout << "counting_sort" << std::endl;
-    bench(&counting_sort);
+    bench([](std::vector<std::size_t>& A){ counting_sort(A); });
 
     std::cout << "in_place_counting_sort" << std::endl;
     bench(&in_place_counting_sort);
 
+    std::cout << "vector_binsort" << std::endl;
+    bench(&vector_binsort);
+
     std::cout << "binsort" << std::endl;
     bench(&::binsort);
 
+    std::cout << "msd_binsort" << std::endl;
+    bench(&msd_binsort);
+
     std::cout << "radix_sort" << std::endl;
-    bench(&radix_sort);
+    bench([](std::vector<std::size_t>& A){ radix_sort(A); });
+
+    std::cout << "adaptive_counting_sort" << std::endl;
+    bench(&adaptive_counting_sort);
+
+    //Sweep the key density to see where the counting and radix passes win
+    for(std::size_t max = SIZE / 16; max <= SIZE * 16; max *= 4){
+        std::cout << "MAX/SIZE = " << static_cast<double>(max) / SIZE << std::endl;
+
+        std::cout << "counting_sort_range" << std::endl;
+        bench([max](std::vector<std::size_t>& A){ counting_sort_range(A, 0, max); }, max);
+
+        std::cout << "radix_sort" << std::endl;
+        bench([](std::vector<std::size_t>& A){ radix_sort(A, [](std::size_t key){ return key; }); }, max);
+
+        std::cout << "adaptive_counting_sort" << std::endl;
+        bench(&adaptive_counting_sort, max);
+    }
+
+    //Adaptive sorts only show their advantage on skewed or presorted inputs
+    for(auto distribution : generators::all_distributions){
+        std::cout << "distribution = " << generators::name(distribution) << std::endl;
+
+        std::cout << "std::sort" << std::endl;
+        bench(&std_sort, MAX, distribution);
+
+        std::cout << "plf::timsort" << std::endl;
+        bench(&::timsort, MAX, distribution);
+
+        std::cout << "parallel_radix_sort (" << max_threads << " threads)" << std::endl;
+        bench([max_threads](std::vector<std::size_t>& A){ parallel_radix_sort(A, max_threads); }, MAX, distribution);
+
+        std::cout << "sample_sort (" << max_threads << " threads)" << std::endl;
+        bench([max_threads](std::vector<std::size_t>& A){ sample_sort(A, max_threads); }, MAX, distribution);
+
+        std::cout << "counting_sort" << std::endl;
+        bench([](std::vector<std::size_t>& A){ counting_sort(A); }, MAX, distribution);
+
+        std::cout << "msd_binsort" << std::endl;
+        bench(&msd_binsort, MAX, distribution);
+
+        std::cout << "radix_sort" << std::endl;
+        bench([](std::vector<std::size_t>& A){ radix_sort(A); }, MAX, distribution);
+
+        std::cout << "adaptive_counting_sort" << std::endl;
+        bench(&adaptive_counting_sort, MAX, distribution);
+    }
+
+    bench_records<8>();
+    bench_records<32>();
+    bench_records<128>();
+    bench_records<1024>();
 
     return 0;
 }
@@ -0,0 +1,128 @@
+//=======================================================================
+// Copyright (c) 2014 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstdint>
+#include <cstring>
+
+#include "perf.hpp"
+
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct event {
+    std::uint32_t type;
+    std::uint64_t config;
+    double graphs::counters::* field;
+};
+
+const event events[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &graphs::counters::cycles},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &graphs::counters::instructions},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &graphs::counters::cache_misses},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &graphs::counters::branch_misses},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), &graphs::counters::dtlb_misses}
+};
+
+const std::size_t event_count = sizeof(events) / sizeof(events[0]);
+
+int perf_event_open(perf_event_attr* attr, int group_fd){
+    return syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+} //end of anonymous namespace
+
+perf::counter_group::counter_group() : fds(event_count, -1), leader(-1) {
+    for(std::size_t i = 0; i < event_count; ++i){
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = leader == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[i] = perf_event_open(&attr, leader);
+
+        if(leader == -1){
+            leader = fds[i];
+        }
+    }
+}
+
+perf::counter_group::~counter_group(){
+    for(auto fd : fds){
+        if(fd != -1){
+            close(fd);
+        }
+    }
+}
+
+bool perf::counter_group::available() const {
+    return leader != -1;
+}
+
+void perf::counter_group::start(){
+    if(leader != -1){
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+graphs::counters perf::counter_group::stop(){
+    auto counters = graphs::unavailable_counters();
+
+    if(leader == -1){
+        return counters;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time_enabled, time_running, then one value per opened event
+    std::uint64_t buffer[3 + event_count];
+
+    if(read(leader, buffer, sizeof(buffer)) <= 0 || buffer[2] == 0){
+        return counters;
+    }
+
+    // scale the counts if the group has been multiplexed
+    const double scale = static_cast<double>(buffer[1]) / buffer[2];
+
+    std::size_t value = 3;
+    for(std::size_t i = 0; i < event_count && value < 3 + buffer[0]; ++i){
+        if(fds[i] != -1){
+            counters.*events[i].field = buffer[value++] * scale;
+        }
+    }
+
+    return counters;
+}
+
+#else
+
+perf::counter_group::counter_group() : leader(-1) {}
+perf::counter_group::~counter_group(){}
+
+bool perf::counter_group::available() const {
+    return false;
+}
+
+void perf::counter_group::start(){}
+
+graphs::counters perf::counter_group::stop(){
+    return graphs::unavailable_counters();
+}
+
+#endif
@@ -17,6 +17,9 @@
 #include <typeinfo>
 #include <memory>
 
+#include "plf_timsort.h"
+#include "plf_colony.h"
+
 #include "bench.hpp"
 #include "policies.hpp"
 
@@ -307,7 +310,12 @@ void bench_all(){
     bench_types<bench_number_crunching, TrivialSmall, TrivialMedium>();
 }
 
-int main(){
+int main(int argc, char* argv[]){
+    //The optional argument is the graph.csv of a previous run to compare with
+    if(argc > 1 && !graphs::load_baseline(argv[1])){
+        return 1;
+    }
+
     //Launch all the graphs
     bench_all<
         TrivialSmall,
@@ -321,6 +329,12 @@ int main(){
 
     //Generate the graphs
     graphs::output(graphs::Output::GOOGLE);
+    graphs::output(graphs::Output::JSON);
+    graphs::output(graphs::Output::CSV);
+
+    if(argc > 1 && graphs::check_regressions()){
+        return 1;
+    }
 
     return 0;
 }
@@ -19,11 +19,22 @@
 #include <set>
 #include <unordered_set>
 
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
 #include "plf_timsort.h"
 #include "plf_colony.h"
 
 #include "bench.hpp"
 #include "policies.hpp"
+#include "allocators.hpp"
+#include "flat_hash_set.hpp"
+#include "sorted_vector.hpp"
+#include "btree.hpp"
+#include "eytzinger.hpp"
+#include "soa_vector.hpp"
+#include "small_vector.hpp"
 
 namespace {
 
@@ -78,6 +89,36 @@ constexpr bool is_small(){
 
 } //end of anonymous namespace
 
+// node based containers without one new/delete per node
+
+template<typename T>
+using pool_list = std::list<T, allocators::pool_allocator<T>>;
+
+template<typename T>
+using arena_deque = std::deque<T, allocators::arena_allocator<T>>;
+
+// hash sets of the tested types, keyed by their a field
+
+struct hash_a {
+    template<typename T>
+    std::size_t operator()(const T& value) const {
+        return std::hash<std::size_t>()(value.a);
+    }
+};
+
+struct equal_a {
+    template<typename T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        return lhs.a == rhs.a;
+    }
+};
+
+template<typename T>
+using unordered_set = std::unordered_set<T, hash_a, equal_a>;
+
+template<typename T>
+using flat_hash_set = containers::flat_hash_set<T, hash_a, equal_a>;
+
 // tested types
 
 // trivial type with parametrized size
@@ -157,6 +198,46 @@ static_assert(is_non_trivial_non_nothrow_movable<NonTrivialStringMovable>(), "In
 using NonTrivialArrayMedium = NonTrivialArray<32>;
 static_assert(is_non_trivial_of_size<NonTrivialArrayMedium>(32), "Invalid type");
 
+// structure of arrays storage of the trivial types with a payload
+
+template<typename T>
+struct has_payload : std::false_type {};
+
+template<int N>
+struct has_payload<Trivial<N>> : std::integral_constant<bool, (N > sizeof(std::size_t))> {};
+
+namespace containers {
+
+template<int N>
+struct soa_traits<Trivial<N>> {
+    typedef std::size_t hot_type;
+    typedef decltype(Trivial<N>::b) cold_type;
+
+    static const hot_type& hot(const Trivial<N>& value){
+        return value.a;
+    }
+
+    static const cold_type& cold(const Trivial<N>& value){
+        return value.b;
+    }
+
+    static Trivial<N> join(const hot_type& a, const cold_type& b){
+        return {a, b};
+    }
+};
+
+} //end of namespace containers
+
+template<typename T, typename DurationUnit, template<class> class CreatePolicy, template<class> class ...TestPolicy>
+typename std::enable_if<has_payload<T>::value>::type bench_soa(const std::string& type, const std::initializer_list<int> &sizes){
+    bench<containers::soa_vector<T>, DurationUnit, CreatePolicy, TestPolicy...>(type, sizes);
+}
+
+template<typename T, typename DurationUnit, template<class> class CreatePolicy, template<class> class ...TestPolicy>
+typename std::enable_if<!has_payload<T>::value>::type bench_soa(const std::string&, const std::initializer_list<int> &){
+    //Nothing to split
+}
+
 // Define all benchmarks
 
 template<typename T>
@@ -171,14 +252,43 @@ struct bench_fill_back {
 
         bench<std::vector<T>, microseconds, Empty, ReserveSize, FillBack>("vector_reserve", sizes);
 
+        bench<pool_list<T>,   microseconds, Empty, FillBack>("list_pool",   sizes);
+        bench<arena_deque<T>, microseconds, Empty, FillBack>("deque_arena", sizes);
+
         bench<plf::colony<T>, microseconds, Empty, InsertSimple>("colony",  sizes);
         bench<plf::colony<T>, microseconds, Empty, ReserveSize, InsertSimple>("colony_reserve", sizes);
+        bench<plf::colony<T>, microseconds, Empty, InsertFill>("colony_fill", sizes);
+        bench<plf::colony<T>, microseconds, Empty, InsertRange>("colony_range", sizes);
 
         bench<plf::colony<T,std::allocator<T>, unsigned int>, microseconds, Empty, InsertSimple>("colony",  sizes);
         bench<plf::colony<T,std::allocator<T>, unsigned int>, microseconds, Empty, ReserveSize, InsertSimple>("colony_reserve", sizes);
     }
 };
 
+template<typename T>
+struct bench_small_fill_back {
+    static void run(){
+        new_graph<T>("small_fill_back", "us");
+
+        auto sizes = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+        bench<std::vector<T>,                  microseconds, Empty, FillBackRepeat>("vector",          sizes);
+        bench<containers::small_vector<T, 16>, microseconds, Empty, FillBackRepeat>("small_vector_16", sizes);
+        bench<containers::small_vector<T, 64>, microseconds, Empty, FillBackRepeat>("small_vector_64", sizes);
+    }
+};
+
+template<typename T>
+struct bench_many_small {
+    static void run(){
+        new_graph<T>("many_small", "ms");
+
+        auto sizes = { 1, 2, 4, 8, 16, 32 };
+        bench<std::vector<T>,                  milliseconds, Empty, FillBackMany>("vector",          sizes);
+        bench<containers::small_vector<T, 8>,  milliseconds, Empty, FillBackMany>("small_vector_8",  sizes);
+        bench<containers::small_vector<T, 16>, milliseconds, Empty, FillBackMany>("small_vector_16", sizes);
+    }
+};
+
 template<typename T>
 struct bench_emplace_back {
     static void run(){
@@ -240,6 +350,7 @@ struct bench_linear_search {
         bench<std::list<T>,   microseconds, FilledRandom, Find>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, Find>("deque",  sizes);
         bench<plf::colony<T>, microseconds, FilledRandomInsert, Find>("colony",  sizes);
+        bench<plf::colony<T>, microseconds, FilledRandomInsert, MemberFindIf>("colony_find_if",  sizes);
     }
 };
 
@@ -252,6 +363,8 @@ struct bench_random_insert {
         bench<std::vector<T>, milliseconds, FilledRandom, Insert>("vector", sizes);
         bench<std::list<T>,   milliseconds, FilledRandom, Insert>("list",   sizes);
         bench<std::deque<T>,  milliseconds, FilledRandom, Insert>("deque",  sizes);
+        bench<pool_list<T>,   milliseconds, FilledRandom, Insert>("list_pool",   sizes);
+        bench<arena_deque<T>, milliseconds, FilledRandom, Insert>("deque_arena", sizes);
         // colony is unordered
     }
 };
@@ -277,14 +390,26 @@ struct bench_random_remove {
 template<typename T>
 struct bench_sort {
     static void run(){
-        new_graph<T>("sort", "ms");
+        // one graph per input distribution, the shuffled one being the historical "sort" graph
+        for(auto distribution : generators::all_distributions){
+            fill_distribution() = distribution;
+
+            if(distribution == generators::Distribution::SHUFFLED){
+                new_graph<T>("sort", "ms");
+            } else {
+                new_graph<T>(std::string("sort_") + generators::name(distribution), "ms");
+            }
+
+            auto sizes = {100000, 200000, 300000, 400000, 500000, 600000, 700000, 800000, 900000, 1000000};
+            bench<std::vector<T>, milliseconds, FilledRandom, Sort>("vector", sizes);
+            bench<std::vector<T>, milliseconds, FilledRandom, TimSort>("vector_timsort", sizes);
+            bench<std::list<T>,   milliseconds, FilledRandom, Sort>("list",   sizes);
+            bench<std::deque<T>,  milliseconds, FilledRandom, Sort>("deque",  sizes);
+            bench<plf::colony<T>,  milliseconds, FilledRandomInsert, Sort>("colony",  sizes);
+            bench<plf::colony<T>,  milliseconds, FilledRandomInsert, TimSort>("colony_timsort",  sizes);
+        }
 
-        auto sizes = {100000, 200000, 300000, 400000, 500000, 600000, 700000, 800000, 900000, 1000000};
-        bench<std::vector<T>, milliseconds, FilledRandom, Sort>("vector", sizes);
-        bench<std::list<T>,   milliseconds, FilledRandom, Sort>("list",   sizes);
-        bench<std::deque<T>,  milliseconds, FilledRandom, Sort>("deque",  sizes);
-        bench<plf::colony<T>,  milliseconds, FilledRandomInsert, Sort>("colony",  sizes);
-        bench<plf::colony<T>,  milliseconds, FilledRandomInsert, TimSort>("colony_timsort",  sizes);
+        fill_distribution() = generators::Distribution::SHUFFLED;
     }
 };
 
@@ -298,6 +423,8 @@ struct bench_destruction {
         bench<std::list<T>,   microseconds, SmartFilled, SmartDelete>("list",   sizes);
         bench<std::deque<T>,  microseconds, SmartFilled, SmartDelete>("deque",  sizes);
         bench<plf::colony<T>,  microseconds, SmartFilled, SmartDelete>("colony",  sizes);
+        bench<pool_list<T>,   microseconds, SmartFilled, SmartDelete>("list_pool",   sizes);
+        bench<arena_deque<T>, microseconds, SmartFilled, SmartDelete>("deque_arena", sizes);
     }
 };
 
@@ -310,7 +437,16 @@ struct bench_number_crunching {
         bench<std::vector<T>, milliseconds, Empty, RandomSortedInsert>("vector", sizes);
         bench<std::list<T>,   milliseconds, Empty, RandomSortedInsert>("list",   sizes);
         bench<std::deque<T>,  milliseconds, Empty, RandomSortedInsert>("deque",  sizes);
+        bench<std::vector<T>, milliseconds, Empty, BinarySortedInsert>("sorted_vector", sizes);
+        bench<containers::sorted_vector<T>, milliseconds, Empty, SetRandomInsert, Flush>("sorted_vector_batch", sizes);
         // colony is unordered
+
+        bench<unordered_set<T>, milliseconds, Empty, SetRandomInsert>("unordered_set", sizes);
+        bench<flat_hash_set<T>, milliseconds, Empty, SetRandomInsert>("flat_hash_set", sizes);
+
+        bench<std::set<T>,              milliseconds, Empty, SetRandomInsert>("set",   sizes);
+        bench<containers::btree_set<T>, milliseconds, Empty, SetRandomInsert>("btree", sizes);
+        // eytzinger is static
     }
 };
 
@@ -324,6 +460,7 @@ struct bench_erase_1 {
         bench<std::list<T>,   microseconds, FilledRandom, RandomErase1>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, RandomErase1>("deque",  sizes);
         bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomErase1>("colony",  sizes);
+        bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomEraseIf1>("colony_erase_if",  sizes);
     }
 };
 
@@ -337,6 +474,7 @@ struct bench_erase_10 {
         bench<std::list<T>,   microseconds, FilledRandom, RandomErase10>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, RandomErase10>("deque",  sizes);
         bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomErase10>("colony",  sizes);
+        bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomEraseIf10>("colony_erase_if",  sizes);
     }
 };
 
@@ -350,6 +488,7 @@ struct bench_erase_25 {
         bench<std::list<T>,   microseconds, FilledRandom, RandomErase25>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, RandomErase25>("deque",  sizes);
         bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomErase25>("colony",  sizes);
+        bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomEraseIf25>("colony_erase_if",  sizes);
     }
 };
 
@@ -363,6 +502,7 @@ struct bench_erase_50 {
         bench<std::list<T>,   microseconds, FilledRandom, RandomErase50>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, RandomErase50>("deque",  sizes);
         bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomErase50>("colony",  sizes);
+        bench<plf::colony<T>,  microseconds, FilledRandomInsert, RandomEraseIf50>("colony_erase_if",  sizes);
     }
 };
 
@@ -376,6 +516,7 @@ struct bench_traversal {
         bench<std::list<T>,   microseconds, FilledRandom, Iterate>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, Iterate>("deque",  sizes);
         bench<plf::colony<T>, microseconds, FilledRandomInsert, Iterate>("colony",  sizes);
+        bench_soa<T, microseconds, FilledRandom, Iterate>("soa", sizes);
     }
 };
 
@@ -389,6 +530,24 @@ struct bench_write {
         bench<std::list<T>,   microseconds, FilledRandom, Write>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, Write>("deque",  sizes);
         bench<plf::colony<T>, microseconds, FilledRandomInsert, Write>("colony",  sizes);
+        bench<plf::colony<T>, microseconds, FilledRandomInsert, ForEachWrite>("colony_for_each",  sizes);
+        bench_soa<T, microseconds, FilledRandom, Write>("soa", sizes);
+    }
+};
+
+template<typename T>
+struct bench_parallel_write {
+    static void run(){
+        new_graph<T>("parallel_write", "us");
+
+        auto sizes = {1000000, 2000000, 3000000, 4000000, 5000000, 6000000, 7000000, 8000000, 9000000, 10000000};
+        bench<plf::colony<T>, microseconds, FilledRandomInsert, Write>("colony",  sizes);
+        bench<plf::colony<T>, microseconds, FilledRandomInsert, ForEachWrite>("colony_for_each",  sizes);
+
+        // the threads of the pool would all share the core of --cpu
+        if(isolation::current().cpu < 0){
+            bench<plf::colony<T>, microseconds, FilledRandomInsert, ParallelWrite>("colony_parallel",  sizes);
+        }
     }
 };
 
@@ -402,6 +561,16 @@ struct bench_find {
         bench<std::list<T>,   microseconds, FilledRandom, Find>("list",   sizes);
         bench<std::deque<T>,  microseconds, FilledRandom, Find>("deque",  sizes);
         bench<plf::colony<T>, microseconds, FilledRandomInsert, Find>("colony",  sizes);
+        bench_soa<T, microseconds, FilledRandom, Find>("soa", sizes);
+
+        bench<std::vector<T>,   microseconds, FilledRandomSorted, BinaryFind>("sorted_vector", sizes);
+        bench<containers::sorted_vector<T>, microseconds, FilledRandomInsert, SortedContains>("sorted_vector_batch", sizes);
+        bench<unordered_set<T>, microseconds, FilledRandomInsert, SetFind>("unordered_set", sizes);
+        bench<flat_hash_set<T>, microseconds, FilledRandomInsert, SetFind>("flat_hash_set", sizes);
+
+        bench<std::set<T>,                    microseconds, FilledRandomInsert, SetFind>("set",       sizes);
+        bench<containers::btree_set<T>,       microseconds, FilledRandomInsert, SetFind>("btree",     sizes);
+        bench<containers::eytzinger_array<T>, microseconds, FilledRandomRange,  SetFind>("eytzinger", sizes);
     }
 };
 
@@ -415,6 +584,7 @@ void bench_all(){
     bench_types<bench_emplace_front,    Types...>();
     bench_types<bench_linear_search,    Types...>();
     bench_types<bench_write,            Types...>();
+    bench_types<bench_traversal,        Types...>();
     bench_types<bench_random_insert,    Types...>();
     bench_types<bench_random_remove,    Types...>();
     bench_types<bench_sort,             Types...>();
@@ -427,9 +597,78 @@ void bench_all(){
     // The following are really slow so run only for limited set of data
     bench_types<bench_find,             TrivialSmall, TrivialMedium, TrivialLarge>();
     bench_types<bench_number_crunching, TrivialSmall, TrivialMedium>();
+
+    // Millions of elements, one thread per core
+    bench_types<bench_parallel_write,   TrivialMedium, TrivialLarge>();
+
+    // Millions of small containers
+    bench_types<bench_small_fill_back,  TrivialSmall, TrivialMedium>();
+    bench_types<bench_many_small,       TrivialSmall, TrivialMedium>();
 }
 
-int main(){
+namespace po = boost::program_options;
+
+int main(int argc, const char* argv[]){
+    po::options_description description("vector_list_update_1 Usage");
+
+    description.add_options()
+        ("help,h", "Display this help message")
+        ("list,l", "List the selected benchmarks instead of running them")
+        ("benchmark,b", po::value<std::vector<std::string>>()->multitoken(), "Benchmarks to run (regexes, e.g. fill_back or 'erase.*')")
+        ("type,t", po::value<std::vector<std::string>>()->multitoken(), "Types to run (regexes, e.g. 'Trivial<8>')")
+        ("container,c", po::value<std::vector<std::string>>()->multitoken(), "Containers to run (regexes, e.g. vector 'colony.*')")
+        ("size,s", po::value<std::vector<std::string>>()->multitoken(), "Sizes to run (regexes, e.g. 10000 '.00000')")
+        ("isolate,i", "Run each benchmark cell (benchmark, type, container, size) in a fresh process")
+        ("cpu", po::value<int>(), "Core to pin the benchmarks to")
+        ("lock-memory", "Lock the memory of the benchmarks (mlockall)")
+        ("allocations,a", "Track the heap allocations of the benchmarks (in an extra untimed run)")
+        ("baseline", po::value<std::string>(), "graph.csv of a previous run to compare with");
+
+    po::positional_options_description p;
+    p.add("baseline", 1);
+
+    po::variables_map vm;
+
+    try {
+        po::store(po::command_line_parser(argc, argv).options(description).positional(p).run(), vm);
+        po::notify(vm);
+
+        for(auto& filter : {std::make_pair("benchmark", &selected().benchmarks), std::make_pair("type", &selected().types),
+                std::make_pair("container", &selected().series), std::make_pair("size", &selected().sizes)}){
+            if(vm.count(filter.first)){
+                select(*filter.second, vm[filter.first].as<std::vector<std::string>>());
+            }
+        }
+    } catch(const po::error& e){
+        std::cerr << e.what() << std::endl << description;
+        return 1;
+    } catch(const std::regex_error& e){
+        std::cerr << "Invalid regex: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if(vm.count("help")){
+        std::cout << description;
+        return 0;
+    }
+
+    selected().list = vm.count("list");
+
+    isolation::current().enabled = vm.count("isolate");
+    isolation::current().cpu = vm.count("cpu") ? vm["cpu"].as<int>() : -1;
+    isolation::current().lock_memory = vm.count("lock-memory");
+
+    allocations::enable(vm.count("allocations"));
+
+    // the isolated processes are pinned and locked when they start
+    if(!isolation::current().enabled && !isolation::apply()){
+        return 1;
+    }
+
+    if(vm.count("baseline") && !graphs::load_baseline(vm["baseline"].as<std::string>())){
+        return 1;
+    }
+
     //Launch all the graphs
     bench_all<
         TrivialSmall,
@@ -441,8 +680,18 @@ int main(){
         NonTrivialStringMovableNoExcept,
         NonTrivialArray<32> >();
 
+    if(selected().list){
+        return 0;
+    }
+
     //Generate the graphs
     graphs::output(graphs::Output::GOOGLE);
+    graphs::output(graphs::Output::JSON);
+    graphs::output(graphs::Output::CSV);
+
+    if(vm.count("baseline") && graphs::check_regressions()){
+        return 1;
+    }
 
     return 0;
 }